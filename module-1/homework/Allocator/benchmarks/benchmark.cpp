@@ -0,0 +1,310 @@
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/allocator/allocator.h"
+#include "../src/list/concurrent_list.h"
+#include "../src/list/list.h"
+#include "benchmark/benchmark.h"
+
+template <typename Allocator>
+void PushBack(benchmark::State& state) {
+    for (auto _ : state) {
+        task::List<std::string, Allocator> list;
+        for (int64_t i = 0; i < state.range(0); i++) {
+            list.PushBack("hello");
+        }
+        benchmark::DoNotOptimize(list.Size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Allocator>
+void PopFront(benchmark::State& state) {
+    for (auto _ : state) {
+        task::List<std::string, Allocator> list;
+        for (int64_t i = 0; i < state.range(0); i++) {
+            list.PushBack("hello");
+        }
+        while (!list.Empty()) {
+            list.PopFront();
+        }
+        benchmark::DoNotOptimize(list.Size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Allocator>
+void Mixed(benchmark::State& state) {
+    for (auto _ : state) {
+        task::List<std::string, Allocator> list;
+        for (int64_t round = 0; round < state.range(0); round++) {
+            for (std::size_t i = 0; i < 5; i++) {
+                list.PushBack("hello");
+            }
+            for (std::size_t i = 0; i < 3; i++) {
+                list.PopFront();
+            }
+            for (std::size_t i = 0; i < 5; i++) {
+                list.PushFront("world");
+            }
+            for (std::size_t i = 0; i < 3; i++) {
+                list.PopBack();
+            }
+        }
+        benchmark::DoNotOptimize(list.Size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 16);
+}
+
+// Appending a ready batch of values: one node at a time or one InsertRange
+template <bool Bulk>
+void Ingest(benchmark::State& state) {
+    std::vector<int64_t> values(static_cast<std::size_t>(state.range(0)), 42);
+    for (auto _ : state) {
+        task::List<int64_t, CustomAllocator<int64_t>> list;
+        if (Bulk) {
+            list.InsertRange(list.End(), values.begin(), values.end());
+        } else {
+            for (int64_t value : values) {
+                list.PushBack(value);
+            }
+        }
+        benchmark::DoNotOptimize(list.Size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Short-lived list of a few elements, as built while serving one request
+template <typename Allocator, typename Storage>
+void ShortList(benchmark::State& state) {
+    for (auto _ : state) {
+        task::List<int64_t, Allocator, Storage> list;
+        for (int64_t i = 0; i < state.range(0); i++) {
+            list.PushBack(i);
+        }
+        benchmark::DoNotOptimize(list.Back());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Every thread churns its own list, so only the allocator is shared
+template <typename Allocator>
+void ThreadedPushPop(benchmark::State& state) {
+    task::List<int64_t, Allocator> list;
+    for (auto _ : state) {
+        for (int64_t i = 0; i < state.range(0); i++) {
+            list.PushBack(i);
+        }
+        while (!list.Empty()) {
+            list.PopFront();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// task::List behind a mutex, the baseline for ConcurrentList
+template <typename T>
+class MutexList {
+public:
+    bool TryPushBack(const T& value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        list_.PushBack(value);
+        return true;
+    }
+
+    bool TryPopFront(T& value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (list_.Empty()) {
+            return false;
+        }
+        value = std::move(list_.Front());
+        list_.PopFront();
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    task::List<T, CustomAllocator<T>> list_;
+};
+
+// Every thread is both a producer and a consumer of one shared queue
+template <typename Queue>
+void QueuePushPop(benchmark::State& state) {
+    static Queue* queue = nullptr;
+    if (state.thread_index() == 0) {
+        queue = new Queue;
+    }
+    for (auto _ : state) {
+        for (int64_t i = 0; i < state.range(0); i++) {
+            queue->TryPushBack(i);
+        }
+        int64_t value = 0;
+        for (int64_t i = 0; i < state.range(0); i++) {
+            queue->TryPopFront(value);
+        }
+        benchmark::DoNotOptimize(value);
+    }
+    if (state.thread_index() == 0) {
+        delete queue;
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Storage>
+task::List<int, std::allocator<int>, Storage> MakeIntList(int64_t count) {
+    task::List<int, std::allocator<int>, Storage> list;
+    for (int64_t i = 0; i < count; i++) {
+        list.PushBack(static_cast<int>(i % 1000));
+    }
+    return list;
+}
+
+template <typename Storage>
+void Iterate(benchmark::State& state) {
+    auto list = MakeIntList<Storage>(state.range(0));
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (auto it = list.Begin(); it != list.End(); ++it) {
+            sum += *it;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Storage>
+void Remove(benchmark::State& state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto list = MakeIntList<Storage>(state.range(0));
+        state.ResumeTiming();
+        list.Remove(7);
+        benchmark::DoNotOptimize(list.Size());
+        state.PauseTiming();
+        list.Clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Storage>
+void Unique(benchmark::State& state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        task::List<int, std::allocator<int>, Storage> list;
+        for (int64_t i = 0; i < state.range(0); i++) {
+            list.PushBack(static_cast<int>(i / 2));
+        }
+        state.ResumeTiming();
+        list.Unique();
+        benchmark::DoNotOptimize(list.Size());
+        state.PauseTiming();
+        list.Clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// range(1) selects the input order: 0 random, 1 sorted, 2 reverse sorted
+std::vector<int> SortInput(benchmark::State& state) {
+    std::vector<int> values(static_cast<std::size_t>(state.range(0)));
+    std::mt19937 random_engine(42);
+    std::generate(values.begin(), values.end(), random_engine);
+    if (state.range(1) == 1) {
+        std::sort(values.begin(), values.end());
+    } else if (state.range(1) == 2) {
+        std::sort(values.rbegin(), values.rend());
+    }
+    return values;
+}
+
+template <bool Parallel>
+void ListSort(benchmark::State& state) {
+    std::vector<int> values = SortInput(state);
+    for (auto _ : state) {
+        state.PauseTiming();
+        task::List<int, CustomAllocator<int>> list;
+        for (int value : values) {
+            list.PushBack(value);
+        }
+        state.ResumeTiming();
+        if (Parallel) {
+            list.ParallelSort();
+        } else {
+            list.Sort();
+        }
+        benchmark::DoNotOptimize(list.Front());
+        state.PauseTiming();
+        list.Clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void StdListSort(benchmark::State& state) {
+    std::vector<int> values = SortInput(state);
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::list<int, CustomAllocator<int>> list(values.begin(), values.end());
+        state.ResumeTiming();
+        list.sort();
+        benchmark::DoNotOptimize(list.front());
+        state.PauseTiming();
+        list.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(PushBack, std::allocator<std::string>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(PushBack, CustomAllocator<std::string>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(PopFront, std::allocator<std::string>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(PopFront, CustomAllocator<std::string>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(Mixed, std::allocator<std::string>)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(Mixed, CustomAllocator<std::string>)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(Ingest, false)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(Ingest, true)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_TEMPLATE(ShortList, std::allocator<int64_t>, task::StableNodes)->DenseRange(2, 8, 3);
+BENCHMARK_TEMPLATE(ShortList, std::allocator<int64_t>, task::InlineNodes<8>)->DenseRange(2, 8, 3);
+BENCHMARK_TEMPLATE(ShortList, CustomAllocator<int64_t>, task::StableNodes)->DenseRange(2, 8, 3);
+BENCHMARK_TEMPLATE(ShortList, CustomAllocator<int64_t>, task::InlineNodes<8>)->DenseRange(2, 8, 3);
+
+BENCHMARK_TEMPLATE(ThreadedPushPop, std::allocator<int64_t>)
+    ->Arg(1 << 12)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(ThreadedPushPop, CustomAllocator<int64_t>)
+    ->Arg(1 << 12)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(QueuePushPop, MutexList<int64_t>)->Arg(64)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(QueuePushPop, task::ConcurrentList<int64_t, CustomAllocator<int64_t>>)
+    ->Arg(64)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(Iterate, task::StableNodes)->Arg(10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(Iterate, task::UnrolledBlocks<>)->Arg(10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(Remove, task::StableNodes)->Arg(10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(Remove, task::UnrolledBlocks<>)->Arg(10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(Unique, task::StableNodes)->Arg(10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(Unique, task::UnrolledBlocks<>)->Arg(10000000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(ListSort, false)
+    ->ArgsProduct({{1 << 20, 1 << 23}, {0, 1, 2}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(ListSort, true)
+    ->ArgsProduct({{1 << 20, 1 << 23}, {0, 1, 2}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(StdListSort)->ArgsProduct({{1 << 20, 1 << 23}, {0, 1, 2}})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
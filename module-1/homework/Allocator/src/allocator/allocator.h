@@ -1,53 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
 #include <memory>
+#include <new>
 #include <type_traits>
 
+#include "pool.h"
+
 template <typename T>
 class CustomAllocator {
 public:
     template <typename U>
     struct rebind {  // NOLINT
-        // Your code goes here
+        using other = CustomAllocator<U>;
     };
 
     using value_type = T;
-    // Your code goes here
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::true_type;
 
-    CustomAllocator();
-    CustomAllocator(const CustomAllocator& other) noexcept;
-    ~CustomAllocator();
+    CustomAllocator() = default;
+    CustomAllocator(const CustomAllocator& other) noexcept = default;
+    ~CustomAllocator() = default;
 
     template <typename U>
-    explicit CustomAllocator(const CustomAllocator<U>& other) noexcept;
+    explicit CustomAllocator(const CustomAllocator<U>& other) noexcept {
+    }
 
     T* allocate(size_t n) {  // NOLINT
-        // Your code goes here        
+        if (n > max_size()) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(pool::Allocate(n * sizeof(T), alignof(T)));
+    }
+    // Extension used by task::List: fills out with count separate blocks of one T
+    // each, every block is later released with deallocate(p, 1)
+    void allocate_batch(T** out, size_type count) {  // NOLINT
+        pool::AllocateBatch(sizeof(T), alignof(T), out, count);
     }
     void deallocate(T* p, size_t n) {  // NOLINT
-        // Your code goes here
+        pool::Deallocate(p, n * sizeof(T), alignof(T));
     };
     template <typename... Args>
     void construct(pointer p, Args&&... args) {  // NOLINT
-        // Your code goes here
+        ::new (static_cast<void*>(p)) T(std::forward<Args>(args)...);
     };
     void destroy(pointer p) {  // NOLINT
-        // Your code goes here
+        p->~T();
     };
+    size_type max_size() const noexcept {  // NOLINT
+        return std::numeric_limits<size_type>::max() / sizeof(T);
+    }
 
     template <typename K, typename U>
     friend bool operator==(const CustomAllocator<K>& lhs, const CustomAllocator<U>& rhs) noexcept;
     template <typename K, typename U>
     friend bool operator!=(const CustomAllocator<K>& lhs, const CustomAllocator<U>& rhs) noexcept;
-
-private:
-    // Your code goes here
 };
 
 template <typename T, typename U>
 bool operator==(const CustomAllocator<T>& lhs, const CustomAllocator<U>& rhs) noexcept {
-    // Your code goes here
+    return true;
 }
 
 template <typename T, typename U>
 bool operator!=(const CustomAllocator<T>& lhs, const CustomAllocator<U>& rhs) noexcept {
-    // Your code goes here
-}
\ No newline at end of file
+    return !(lhs == rhs);
+}
@@ -0,0 +1,411 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "size_class.h"
+#include "stats.h"
+
+namespace pool {
+
+// A thread keeps at most kMagazineSize free blocks per size class and trades
+// them with the central pool kBatchSize blocks at a time
+constexpr std::size_t kMagazineSize = 64;
+constexpr std::size_t kBatchSize = kMagazineSize / 2;
+
+constexpr std::size_t kCacheLineSize = 64;
+
+// Free blocks are threaded into an intrusive singly linked list
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+// Chain of free blocks moved between a magazine and the central pool as a unit
+struct Batch {
+    FreeBlock* head = nullptr;
+    FreeBlock* tail = nullptr;
+    std::size_t count = 0;
+};
+
+class ThreadCache;
+
+// Slabs are aligned to kSlabSize, so the header of a pooled block is found by
+// masking its address. A slab serves one size class and belongs to the thread
+// cache that carved it for its whole lifetime
+struct SlabHeader {
+    ThreadCache* owner;
+    SlabHeader* next;
+    std::size_t size_class;
+};
+
+static_assert(sizeof(SlabHeader) <= kSlabHeaderSize, "SlabHeader does not fit its reserve");
+
+inline SlabHeader* SlabOf(const void* p) noexcept {
+    return reinterpret_cast<SlabHeader*>(reinterpret_cast<std::uintptr_t>(p) &  // NOLINT
+                                         ~(kSlabSize - 1));
+}
+
+// Shared depot behind the thread caches. Each size class has its own lock, which
+// is only taken when a magazine runs empty or overflows
+class CentralPool {
+public:
+    CentralPool(const CentralPool&) = delete;
+    CentralPool& operator=(const CentralPool&) = delete;
+
+    static CentralPool& Instance();
+
+    // Detaches up to max blocks of the given class, the batch may be empty
+    Batch Take(std::size_t index, std::size_t max);
+    void Put(std::size_t index, const Batch& batch) noexcept;
+
+    SlabHeader* NewSlab(std::size_t index, ThreadCache* owner);
+
+    // Thread caches are recycled rather than destroyed: remote frees may still
+    // target the cache of a thread that has already exited
+    ThreadCache* AcquireCache();
+    void ReleaseCache(ThreadCache* cache);
+
+private:
+    struct alignas(kCacheLineSize) Depot {
+        std::mutex mutex;
+        Batch blocks;
+    };
+
+    CentralPool() = default;
+
+    Depot depots_[kNumClasses];
+
+    std::mutex mutex_;
+    SlabHeader* slabs_ = nullptr;
+    std::vector<ThreadCache*> caches_;
+    std::vector<ThreadCache*> idle_caches_;
+};
+
+// tcache-style front end owned by a single thread. Frees of blocks from slabs
+// owned by other caches are pushed onto the owner's lock-free remote stack and
+// are reclaimed by the owner the next time one of its magazines runs empty
+class ThreadCache {
+public:
+    ThreadCache() = default;
+    ThreadCache(const ThreadCache&) = delete;
+    ThreadCache& operator=(const ThreadCache&) = delete;
+
+    void* Allocate(std::size_t index);
+    // Stores count blocks into out, refilling the magazine as often as needed
+    template <typename Block>
+    void AllocateBatch(std::size_t index, Block** out, std::size_t count);
+    void Deallocate(void* p, std::size_t index) noexcept;
+
+    // Safe to call from any thread
+    void PushRemote(void* p) noexcept;
+
+    // Returns every cached block to the central pool
+    void Flush() noexcept;
+
+private:
+    struct Magazine {
+        FreeBlock* head = nullptr;
+        std::size_t count = 0;
+        // Uncarved part of the last slab of this class
+        char* cursor = nullptr;
+        char* end = nullptr;
+    };
+
+    void Refill(std::size_t index);
+    void Spill(std::size_t index) noexcept;
+    void DrainRemote() noexcept;
+
+    Magazine magazines_[kNumClasses];
+    alignas(kCacheLineSize) std::atomic<FreeBlock*> remote_{nullptr};
+};
+
+// CentralPool
+inline CentralPool& CentralPool::Instance() {
+    // Intentionally leaked: containers with static storage duration may still
+    // return their nodes after the pool would have been destroyed
+    static CentralPool* instance = new CentralPool;
+    return *instance;
+}
+
+inline Batch CentralPool::Take(std::size_t index, std::size_t max) {
+    Depot& depot = depots_[index];
+    std::lock_guard<std::mutex> lock(depot.mutex);
+
+    Batch batch;
+    if (depot.blocks.count == 0) {
+        return batch;
+    }
+    batch.head = depot.blocks.head;
+    batch.tail = batch.head;
+    batch.count = 1;
+    while (batch.count < max && batch.tail->next != nullptr) {
+        batch.tail = batch.tail->next;
+        ++batch.count;
+    }
+    depot.blocks.head = batch.tail->next;
+    depot.blocks.count -= batch.count;
+    if (depot.blocks.count == 0) {
+        depot.blocks.tail = nullptr;
+    }
+    batch.tail->next = nullptr;
+    return batch;
+}
+
+inline void CentralPool::Put(std::size_t index, const Batch& batch) noexcept {
+    if (batch.count == 0) {
+        return;
+    }
+    Depot& depot = depots_[index];
+    std::lock_guard<std::mutex> lock(depot.mutex);
+
+    batch.tail->next = depot.blocks.head;
+    depot.blocks.head = batch.head;
+    if (depot.blocks.count == 0) {
+        depot.blocks.tail = batch.tail;
+    }
+    depot.blocks.count += batch.count;
+}
+
+inline SlabHeader* CentralPool::NewSlab(std::size_t index, ThreadCache* owner) {
+    auto slab = static_cast<SlabHeader*>(::operator new(kSlabSize, std::align_val_t(kSlabSize)));
+    slab->owner = owner;
+    slab->size_class = index;
+    stats::OnNewSlab(index);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    slab->next = slabs_;
+    slabs_ = slab;
+    return slab;
+}
+
+inline ThreadCache* CentralPool::AcquireCache() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!idle_caches_.empty()) {
+        ThreadCache* cache = idle_caches_.back();
+        idle_caches_.pop_back();
+        return cache;
+    }
+    caches_.push_back(new ThreadCache);
+    return caches_.back();
+}
+
+inline void CentralPool::ReleaseCache(ThreadCache* cache) {
+    cache->Flush();
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_caches_.push_back(cache);
+}
+
+// ThreadCache
+inline void* ThreadCache::Allocate(std::size_t index) {
+    Magazine& magazine = magazines_[index];
+    if (magazine.head == nullptr) {
+        Refill(index);
+    }
+    FreeBlock* block = magazine.head;
+    magazine.head = block->next;
+    --magazine.count;
+    return block;
+}
+
+template <typename Block>
+void ThreadCache::AllocateBatch(std::size_t index, Block** out, std::size_t count) {
+    Magazine& magazine = magazines_[index];
+    for (std::size_t i = 0; i < count; ++i) {
+        if (magazine.head == nullptr) {
+            try {
+                Refill(index);
+            } catch (...) {
+                while (i > 0) {
+                    Deallocate(out[--i], index);
+                }
+                throw;
+            }
+        }
+        FreeBlock* block = magazine.head;
+        magazine.head = block->next;
+        --magazine.count;
+        out[i] = static_cast<Block*>(static_cast<void*>(block));
+    }
+}
+
+inline void ThreadCache::Deallocate(void* p, std::size_t index) noexcept {
+    Magazine& magazine = magazines_[index];
+    auto block = static_cast<FreeBlock*>(p);
+    block->next = magazine.head;
+    magazine.head = block;
+    if (++magazine.count > kMagazineSize) {
+        Spill(index);
+    }
+}
+
+inline void ThreadCache::PushRemote(void* p) noexcept {
+    stats::OnRemoteFree();
+    auto block = static_cast<FreeBlock*>(p);
+    block->next = remote_.load(std::memory_order_relaxed);
+    while (!remote_.compare_exchange_weak(block->next, block, std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+    }
+}
+
+inline void ThreadCache::Flush() noexcept {
+    DrainRemote();
+    for (std::size_t index = 0; index < kNumClasses; ++index) {
+        while (magazines_[index].count > 0) {
+            Spill(index);
+        }
+    }
+}
+
+inline void ThreadCache::Refill(std::size_t index) {
+    DrainRemote();
+    Magazine& magazine = magazines_[index];
+    if (magazine.head != nullptr) {
+        return;
+    }
+
+    Batch batch = CentralPool::Instance().Take(index, kBatchSize);
+    if (batch.count > 0) {
+        magazine.head = batch.head;
+        magazine.count = batch.count;
+        return;
+    }
+
+    std::size_t block_size = ClassSize(index);
+    for (std::size_t carved = 0; carved < kBatchSize; ++carved) {
+        if (static_cast<std::size_t>(magazine.end - magazine.cursor) < block_size) {
+            if (carved > 0) {
+                break;
+            }
+            auto slab = reinterpret_cast<char*>(CentralPool::Instance().NewSlab(index, this));
+            magazine.cursor = slab + kSlabHeaderSize;
+            magazine.end = magazine.cursor + BlocksPerSlab(index) * block_size;
+        }
+        auto block = reinterpret_cast<FreeBlock*>(magazine.cursor);
+        magazine.cursor += block_size;
+        block->next = magazine.head;
+        magazine.head = block;
+        ++magazine.count;
+    }
+}
+
+inline void ThreadCache::Spill(std::size_t index) noexcept {
+    Magazine& magazine = magazines_[index];
+    Batch batch;
+    batch.head = magazine.head;
+    batch.tail = batch.head;
+    batch.count = 1;
+    while (batch.count < kBatchSize && batch.tail->next != nullptr) {
+        batch.tail = batch.tail->next;
+        ++batch.count;
+    }
+    magazine.head = batch.tail->next;
+    magazine.count -= batch.count;
+    batch.tail->next = nullptr;
+    CentralPool::Instance().Put(index, batch);
+}
+
+inline void ThreadCache::DrainRemote() noexcept {
+    if (remote_.load(std::memory_order_relaxed) == nullptr) {
+        return;
+    }
+    FreeBlock* block = remote_.exchange(nullptr, std::memory_order_acquire);
+    while (block != nullptr) {
+        FreeBlock* next = block->next;
+        Deallocate(block, SlabOf(block)->size_class);
+        block = next;
+    }
+}
+
+// Per-thread binding
+struct ThreadCacheSlot {
+    ThreadCache* cache = nullptr;
+};
+
+inline thread_local ThreadCacheSlot tls_cache_slot;
+
+class ThreadCacheOwner {
+public:
+    ThreadCacheOwner() = default;
+    ThreadCacheOwner(const ThreadCacheOwner&) = delete;
+    ThreadCacheOwner& operator=(const ThreadCacheOwner&) = delete;
+
+    ~ThreadCacheOwner() {
+        ThreadCache* cache = tls_cache_slot.cache;
+        tls_cache_slot.cache = nullptr;
+        CentralPool::Instance().ReleaseCache(cache);
+    }
+};
+
+// Cache bound to the calling thread, nullptr if the thread has not allocated yet
+inline ThreadCache* PeekThreadCache() noexcept {
+    return tls_cache_slot.cache;
+}
+
+inline ThreadCache* GetThreadCache() {
+    if (tls_cache_slot.cache != nullptr) {
+        return tls_cache_slot.cache;
+    }
+    // A thread which allocates again from its thread_local destructors after
+    // the owner is gone gets a fresh cache that is never handed back
+    static thread_local ThreadCacheOwner owner;
+    tls_cache_slot.cache = CentralPool::Instance().AcquireCache();
+    return tls_cache_slot.cache;
+}
+
+// Entry points used by CustomAllocator. Requests which do not fit a size class
+// are forwarded to ::operator new
+inline void* Allocate(std::size_t bytes, std::size_t alignment) {
+    if (!IsPooled(bytes, alignment)) {
+        void* p = ::operator new(bytes, std::align_val_t(alignment));
+        stats::OnLargeAllocate(bytes);
+        return p;
+    }
+    std::size_t index = ClassIndex(bytes);
+    void* p = GetThreadCache()->Allocate(index);
+    stats::OnAllocate(index);
+    return p;
+}
+
+inline void Deallocate(void* p, std::size_t bytes, std::size_t alignment) noexcept {
+    if (!IsPooled(bytes, alignment)) {
+        stats::OnLargeDeallocate(bytes);
+        ::operator delete(p, std::align_val_t(alignment));
+        return;
+    }
+    std::size_t index = ClassIndex(bytes);
+    stats::OnDeallocate(index);
+    ThreadCache* owner = SlabOf(p)->owner;
+    if (owner == PeekThreadCache()) {
+        owner->Deallocate(p, index);
+    } else {
+        owner->PushRemote(p);
+    }
+}
+
+// Fills out with count blocks using a single thread cache lookup. Every block
+// is returned on its own with Deallocate
+template <typename Block>
+void AllocateBatch(std::size_t bytes, std::size_t alignment, Block** out, std::size_t count) {
+    if (IsPooled(bytes, alignment)) {
+        std::size_t index = ClassIndex(bytes);
+        GetThreadCache()->AllocateBatch(index, out, count);
+        stats::OnAllocate(index, count);
+        return;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        try {
+            out[i] = static_cast<Block*>(Allocate(bytes, alignment));
+        } catch (...) {
+            while (i > 0) {
+                Deallocate(out[--i], bytes, alignment);
+            }
+            throw;
+        }
+    }
+}
+
+}  // namespace pool
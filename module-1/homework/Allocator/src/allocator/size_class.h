@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+
+namespace pool {
+
+// Every pooled block is a multiple of kAlignment, blocks of one size class are
+// carved out of kSlabSize slabs
+constexpr std::size_t kAlignment = alignof(std::max_align_t);
+constexpr std::size_t kMaxPooledSize = 512;
+constexpr std::size_t kNumClasses = kMaxPooledSize / kAlignment;
+constexpr std::size_t kSlabSize = 64 * 1024;
+// The front of every slab is reserved for its SlabHeader
+constexpr std::size_t kSlabHeaderSize = 2 * kAlignment;
+
+constexpr std::size_t ClassIndex(std::size_t bytes) noexcept {
+    return bytes == 0 ? 0 : (bytes - 1) / kAlignment;
+}
+
+constexpr std::size_t ClassSize(std::size_t index) noexcept {
+    return (index + 1) * kAlignment;
+}
+
+constexpr std::size_t BlocksPerSlab(std::size_t index) noexcept {
+    return (kSlabSize - kSlabHeaderSize) / ClassSize(index);
+}
+
+constexpr bool IsPooled(std::size_t bytes, std::size_t alignment) noexcept {
+    return bytes <= kMaxPooledSize && alignment <= kAlignment;
+}
+
+}  // namespace pool
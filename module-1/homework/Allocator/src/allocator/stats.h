@@ -0,0 +1,173 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+#include "size_class.h"
+
+// Opt-in instrumentation of the node pool. Unless POOL_STATS is defined every
+// hook below is an empty inline function and the counters do not exist
+namespace pool {
+
+#ifdef POOL_STATS
+constexpr bool kStatsEnabled = true;
+#else
+constexpr bool kStatsEnabled = false;
+#endif
+
+struct ClassStats {
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t slabs = 0;
+
+    uint64_t LiveBlocks() const noexcept {
+        return allocations - deallocations;
+    }
+};
+
+struct StatsSnapshot {
+    int64_t live_bytes = 0;
+    int64_t peak_bytes = 0;
+    uint64_t remote_frees = 0;
+    uint64_t large_allocations = 0;
+    int64_t large_live_bytes = 0;
+    ClassStats classes[kNumClasses];
+
+    // Share of the carved slab space of a class occupied by live blocks
+    double Utilization(std::size_t index) const noexcept;
+    std::string ToJson() const;
+};
+
+namespace stats {
+
+#ifdef POOL_STATS
+// Relaxed atomics: counters are only ever summed, never used for synchronization
+struct Counters {
+    std::atomic<int64_t> live_bytes;
+    std::atomic<int64_t> peak_bytes;
+    std::atomic<uint64_t> remote_frees;
+    std::atomic<uint64_t> large_allocations;
+    std::atomic<int64_t> large_live_bytes;
+    std::atomic<uint64_t> allocations[kNumClasses];
+    std::atomic<uint64_t> deallocations[kNumClasses];
+    std::atomic<uint64_t> slabs[kNumClasses];
+};
+
+inline Counters& Global() noexcept {
+    // Zero-initialized static storage, trivially destructible
+    static Counters counters;
+    return counters;
+}
+
+inline void AddLiveBytes(int64_t bytes) noexcept {
+    Counters& counters = Global();
+    int64_t live = counters.live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    int64_t peak = counters.peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !counters.peak_bytes.compare_exchange_weak(
+                              peak, live, std::memory_order_relaxed, std::memory_order_relaxed)) {
+    }
+}
+#endif
+
+inline void OnAllocate(std::size_t index, std::size_t count = 1) noexcept {
+#ifdef POOL_STATS
+    Global().allocations[index].fetch_add(count, std::memory_order_relaxed);
+    AddLiveBytes(static_cast<int64_t>(ClassSize(index) * count));
+#endif
+}
+
+inline void OnDeallocate(std::size_t index) noexcept {
+#ifdef POOL_STATS
+    Global().deallocations[index].fetch_add(1, std::memory_order_relaxed);
+    AddLiveBytes(-static_cast<int64_t>(ClassSize(index)));
+#endif
+}
+
+inline void OnLargeAllocate(std::size_t bytes) noexcept {
+#ifdef POOL_STATS
+    Global().large_allocations.fetch_add(1, std::memory_order_relaxed);
+    Global().large_live_bytes.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+    AddLiveBytes(static_cast<int64_t>(bytes));
+#endif
+}
+
+inline void OnLargeDeallocate(std::size_t bytes) noexcept {
+#ifdef POOL_STATS
+    Global().large_live_bytes.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+    AddLiveBytes(-static_cast<int64_t>(bytes));
+#endif
+}
+
+inline void OnRemoteFree() noexcept {
+#ifdef POOL_STATS
+    Global().remote_frees.fetch_add(1, std::memory_order_relaxed);
+#endif
+}
+
+inline void OnNewSlab(std::size_t index) noexcept {
+#ifdef POOL_STATS
+    Global().slabs[index].fetch_add(1, std::memory_order_relaxed);
+#endif
+}
+
+}  // namespace stats
+
+// Counters are cumulative over the process, tests compare two snapshots.
+// Without POOL_STATS the snapshot is all zeros
+inline StatsSnapshot GetStats() noexcept {
+    StatsSnapshot snapshot;
+#ifdef POOL_STATS
+    const stats::Counters& counters = stats::Global();
+    snapshot.live_bytes = counters.live_bytes.load(std::memory_order_relaxed);
+    snapshot.peak_bytes = counters.peak_bytes.load(std::memory_order_relaxed);
+    snapshot.remote_frees = counters.remote_frees.load(std::memory_order_relaxed);
+    snapshot.large_allocations = counters.large_allocations.load(std::memory_order_relaxed);
+    snapshot.large_live_bytes = counters.large_live_bytes.load(std::memory_order_relaxed);
+    for (std::size_t index = 0; index < kNumClasses; ++index) {
+        ClassStats& cls = snapshot.classes[index];
+        cls.allocations = counters.allocations[index].load(std::memory_order_relaxed);
+        cls.deallocations = counters.deallocations[index].load(std::memory_order_relaxed);
+        cls.slabs = counters.slabs[index].load(std::memory_order_relaxed);
+    }
+#endif
+    return snapshot;
+}
+
+inline double StatsSnapshot::Utilization(std::size_t index) const noexcept {
+    const ClassStats& cls = classes[index];
+    if (cls.slabs == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(cls.LiveBlocks()) /
+           static_cast<double>(cls.slabs * BlocksPerSlab(index));
+}
+
+inline std::string StatsSnapshot::ToJson() const {
+    std::ostringstream out;
+    out << "{\"enabled\": " << (kStatsEnabled ? "true" : "false")
+        << ", \"live_bytes\": " << live_bytes << ", \"peak_bytes\": " << peak_bytes
+        << ", \"remote_frees\": " << remote_frees << ", \"large\": {\"allocations\": "
+        << large_allocations << ", \"live_bytes\": " << large_live_bytes << "}, \"classes\": [";
+    bool first = true;
+    for (std::size_t index = 0; index < kNumClasses; ++index) {
+        const ClassStats& cls = classes[index];
+        if (cls.allocations == 0 && cls.slabs == 0) {
+            continue;
+        }
+        out << (first ? "" : ", ") << "{\"size\": " << ClassSize(index)
+            << ", \"allocations\": " << cls.allocations << ", \"live_blocks\": " << cls.LiveBlocks()
+            << ", \"slabs\": " << cls.slabs << ", \"utilization\": " << Utilization(index) << "}";
+        first = false;
+    }
+    out << "]}";
+    return out.str();
+}
+
+inline std::string DumpStats() {
+    return GetStats().ToJson();
+}
+
+}  // namespace pool
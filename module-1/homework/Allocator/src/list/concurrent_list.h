@@ -0,0 +1,339 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "list.h"
+
+namespace task {
+
+// Lock-free multi-producer multi-consumer FIFO queue (Michael & Scott). Nodes
+// come from Allocator like the nodes of List and are reclaimed through hazard
+// pointers: a dequeued node is only returned to the allocator once no thread
+// is still reading it.
+//
+// Construction and destruction are not thread safe, every other member is.
+// The allocator must be safe to use from several threads, CustomAllocator is
+template <typename T, typename Allocator = std::allocator<T>>
+class ConcurrentList {
+    static_assert(std::is_nothrow_move_assignable<T>::value &&
+                      std::is_nothrow_destructible<T>::value,
+                  "Values are moved out of the queue after they have been unlinked");
+
+private:
+    // The head of the queue is a dummy node whose value has already been taken
+    // or was never constructed. The value of the new head is moved out after
+    // the node may already have been retired by the next consumer, so retired
+    // nodes are linked through a field of their own
+    struct Node {
+        T* Value() noexcept {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+
+        std::atomic<Node*> next{nullptr};
+        Node* retired_next = nullptr;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    // A thread holds a record for the duration of one operation. Hazards
+    // protect the nodes it dereferences, retired nodes wait on the record
+    // until a scan finds them unprotected
+    struct alignas(kCacheLineSize) HazardRecord {
+        std::atomic<Node*> hazards[2] = {};
+        std::atomic<bool> active{false};
+        HazardRecord* next = nullptr;
+        Node* retired = nullptr;
+        std::size_t retired_count = 0;
+    };
+
+    using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+    using node_traits = std::allocator_traits<node_allocator>;
+
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+
+    ConcurrentList() : ConcurrentList(Allocator()) {
+    }
+    explicit ConcurrentList(const Allocator& alloc);
+
+    ConcurrentList(const ConcurrentList&) = delete;
+    ConcurrentList& operator=(const ConcurrentList&) = delete;
+
+    ~ConcurrentList();
+
+    // Returns false, leaving the queue untouched, if no node could be allocated
+    bool TryPushBack(const T& value);
+    bool TryPushBack(T&& value);
+
+    // Moves the front element into value, returns false if the queue is empty
+    bool TryPopFront(T& value);
+
+    // A snapshot, other threads may change the queue right after
+    bool Empty() const noexcept;
+
+    allocator_type GetAllocator() const noexcept {
+        return allocator_type(alloc_);
+    }
+
+private:
+    template <typename Arg>
+    bool Enqueue(Arg&& value);
+
+    HazardRecord* AcquireRecord();
+    static void ReleaseRecord(HazardRecord* record) noexcept;
+
+    // Publishes the value of source as hazard slot of record, returns the
+    // protected node
+    static Node* Protect(HazardRecord* record, std::size_t slot, const std::atomic<Node*>& source);
+
+    void Retire(HazardRecord* record, Node* node) noexcept;
+    void Scan(HazardRecord* record) noexcept;
+    bool IsHazard(const Node* node) const noexcept;
+
+    void DestroyNode(Node* node) noexcept;
+
+    // Retired nodes a record collects before it scans the hazards. Grows with
+    // the number of records so that every scan frees most of them
+    std::size_t RetireThreshold() const noexcept {
+        return 4 * records_count_.load(std::memory_order_relaxed) + 64;
+    }
+
+    alignas(kCacheLineSize) std::atomic<Node*> head_;
+    alignas(kCacheLineSize) std::atomic<Node*> tail_;
+    alignas(kCacheLineSize) std::atomic<HazardRecord*> records_{nullptr};
+    std::atomic<std::size_t> records_count_{0};
+    node_allocator alloc_;
+};
+
+template <typename T, typename Allocator>
+ConcurrentList<T, Allocator>::ConcurrentList(const Allocator& alloc) : alloc_(alloc) {
+    Node* dummy = node_traits::allocate(alloc_, 1);
+    ::new (static_cast<void*>(dummy)) Node;
+    head_.store(dummy, std::memory_order_relaxed);
+    tail_.store(dummy, std::memory_order_relaxed);
+}
+
+template <typename T, typename Allocator>
+ConcurrentList<T, Allocator>::~ConcurrentList() {
+    Node* node = head_.load(std::memory_order_relaxed);
+    Node* next = node->next.load(std::memory_order_relaxed);
+    DestroyNode(node);
+    for (node = next; node != nullptr; node = next) {
+        next = node->next.load(std::memory_order_relaxed);
+        node->Value()->~T();
+        DestroyNode(node);
+    }
+
+    HazardRecord* record = records_.load(std::memory_order_relaxed);
+    while (record != nullptr) {
+        while (record->retired != nullptr) {
+            Node* retired = record->retired;
+            record->retired = retired->retired_next;
+            DestroyNode(retired);
+        }
+        HazardRecord* next_record = record->next;
+        delete record;
+        record = next_record;
+    }
+}
+
+template <typename T, typename Allocator>
+bool ConcurrentList<T, Allocator>::TryPushBack(const T& value) {
+    return Enqueue(value);
+}
+
+template <typename T, typename Allocator>
+bool ConcurrentList<T, Allocator>::TryPushBack(T&& value) {
+    return Enqueue(std::move(value));
+}
+
+template <typename T, typename Allocator>
+template <typename Arg>
+bool ConcurrentList<T, Allocator>::Enqueue(Arg&& value) {
+    Node* node = nullptr;
+    try {
+        node = node_traits::allocate(alloc_, 1);
+    } catch (const std::bad_alloc&) {
+        return false;
+    }
+    ::new (static_cast<void*>(node)) Node;
+    try {
+        ::new (static_cast<void*>(node->storage)) T(std::forward<Arg>(value));
+    } catch (...) {
+        DestroyNode(node);
+        throw;
+    }
+
+    HazardRecord* record = nullptr;
+    try {
+        record = AcquireRecord();
+    } catch (const std::bad_alloc&) {
+        node->Value()->~T();
+        DestroyNode(node);
+        return false;
+    }
+
+    while (true) {
+        Node* tail = Protect(record, 0, tail_);
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (tail != tail_.load(std::memory_order_acquire)) {
+            continue;
+        }
+        if (next != nullptr) {
+            // Another producer linked its node but has not swung the tail yet
+            tail_.compare_exchange_weak(tail, next, std::memory_order_release,
+                                        std::memory_order_relaxed);
+            continue;
+        }
+        if (tail->next.compare_exchange_weak(next, node, std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+            tail_.compare_exchange_strong(tail, node, std::memory_order_release,
+                                          std::memory_order_relaxed);
+            break;
+        }
+    }
+    ReleaseRecord(record);
+    return true;
+}
+
+template <typename T, typename Allocator>
+bool ConcurrentList<T, Allocator>::TryPopFront(T& value) {
+    HazardRecord* record = AcquireRecord();
+    Node* head = nullptr;
+    Node* next = nullptr;
+    while (true) {
+        head = Protect(record, 0, head_);
+        Node* tail = tail_.load(std::memory_order_acquire);
+        next = Protect(record, 1, head->next);
+        if (head != head_.load(std::memory_order_acquire)) {
+            continue;
+        }
+        if (next == nullptr) {
+            ReleaseRecord(record);
+            return false;
+        }
+        if (head == tail) {
+            // The tail lags behind a linked node, help it before dequeuing
+            tail_.compare_exchange_weak(tail, next, std::memory_order_release,
+                                        std::memory_order_relaxed);
+            continue;
+        }
+        if (head_.compare_exchange_weak(head, next, std::memory_order_acq_rel,
+                                        std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    // next is the new dummy: only the thread which swung the head touches its value
+    value = std::move(*next->Value());
+    next->Value()->~T();
+    Retire(record, head);
+    ReleaseRecord(record);
+    return true;
+}
+
+template <typename T, typename Allocator>
+bool ConcurrentList<T, Allocator>::Empty() const noexcept {
+    // Reading head->next would need a hazard. The tail never falls behind the
+    // head, so equal ends mean that no node is linked or its producer has not
+    // swung the tail yet
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+}
+
+template <typename T, typename Allocator>
+typename ConcurrentList<T, Allocator>::HazardRecord* ConcurrentList<T, Allocator>::AcquireRecord() {
+    for (HazardRecord* record = records_.load(std::memory_order_acquire); record != nullptr;
+         record = record->next) {
+        if (!record->active.load(std::memory_order_relaxed) &&
+            !record->active.exchange(true, std::memory_order_acquire)) {
+            return record;
+        }
+    }
+
+    // Records are never freed before the queue, so the list only grows
+    auto record = new HazardRecord;
+    record->active.store(true, std::memory_order_relaxed);
+    record->next = records_.load(std::memory_order_relaxed);
+    while (!records_.compare_exchange_weak(record->next, record, std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+    }
+    records_count_.fetch_add(1, std::memory_order_relaxed);
+    return record;
+}
+
+template <typename T, typename Allocator>
+void ConcurrentList<T, Allocator>::ReleaseRecord(HazardRecord* record) noexcept {
+    record->hazards[0].store(nullptr, std::memory_order_release);
+    record->hazards[1].store(nullptr, std::memory_order_release);
+    record->active.store(false, std::memory_order_release);
+}
+
+template <typename T, typename Allocator>
+typename ConcurrentList<T, Allocator>::Node* ConcurrentList<T, Allocator>::Protect(
+    HazardRecord* record, std::size_t slot, const std::atomic<Node*>& source) {
+    // The hazard only counts once source is seen to still hold the node after
+    // publication, otherwise the node may have been retired in between
+    Node* node = source.load(std::memory_order_relaxed);
+    while (true) {
+        record->hazards[slot].store(node, std::memory_order_seq_cst);
+        Node* current = source.load(std::memory_order_seq_cst);
+        if (current == node) {
+            return node;
+        }
+        node = current;
+    }
+}
+
+template <typename T, typename Allocator>
+void ConcurrentList<T, Allocator>::Retire(HazardRecord* record, Node* node) noexcept {
+    node->retired_next = record->retired;
+    record->retired = node;
+    if (++record->retired_count >= RetireThreshold()) {
+        Scan(record);
+    }
+}
+
+template <typename T, typename Allocator>
+void ConcurrentList<T, Allocator>::Scan(HazardRecord* record) noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    Node* retired = record->retired;
+    record->retired = nullptr;
+    record->retired_count = 0;
+    while (retired != nullptr) {
+        Node* next = retired->retired_next;
+        if (IsHazard(retired)) {
+            retired->retired_next = record->retired;
+            record->retired = retired;
+            ++record->retired_count;
+        } else {
+            DestroyNode(retired);
+        }
+        retired = next;
+    }
+}
+
+template <typename T, typename Allocator>
+bool ConcurrentList<T, Allocator>::IsHazard(const Node* node) const noexcept {
+    for (HazardRecord* record = records_.load(std::memory_order_acquire); record != nullptr;
+         record = record->next) {
+        if (record->hazards[0].load(std::memory_order_seq_cst) == node ||
+            record->hazards[1].load(std::memory_order_seq_cst) == node) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T, typename Allocator>
+void ConcurrentList<T, Allocator>::DestroyNode(Node* node) noexcept {
+    node->~Node();
+    node_traits::deallocate(alloc_, node, 1);
+}
+
+}  // namespace task
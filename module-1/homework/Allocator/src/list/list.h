@@ -1,23 +1,198 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
 #include <list>
 #include <memory>
+#include <system_error>
+#include <thread>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace task {
 
-template <typename T, typename Allocator = std::allocator<T>>
+constexpr std::size_t kCacheLineSize = 64;
+
+// Storage policies of List. StableNodes keeps one node per element, so
+// iterators and references survive every operation except erasing their own
+// element. InlineNodes additionally keeps up to N nodes inside the List object
+// and only asks the allocator for more; moving or swapping the list relocates
+// those elements, invalidating iterators to them. UnrolledBlocks packs elements
+// into blocks of BlockBytes for faster traversal at the cost of iterator
+// stability
+struct StableNodes {};
+
+template <std::size_t N = 8>
+struct InlineNodes {};
+
+template <std::size_t BlockBytes = 4 * kCacheLineSize>
+struct UnrolledBlocks {};
+
+// Allocators may offer allocate_batch(out, count) which hands out count single
+// objects in one call, each one is still released with deallocate(p, 1)
+template <typename Alloc, typename = void>
+struct HasAllocateBatch : std::false_type {};
+
+template <typename Alloc>
+struct HasAllocateBatch<Alloc, std::void_t<decltype(std::declval<Alloc&>().allocate_batch(
+                                   std::declval<typename Alloc::value_type**>(), std::size_t()))>>
+    : std::true_type {};
+
+template <typename Storage>
+struct InlineCapacity : std::integral_constant<std::size_t, 0> {};
+
+template <std::size_t N>
+struct InlineCapacity<InlineNodes<N>> : std::integral_constant<std::size_t, N> {};
+
+// Calls task(0), ..., task(count - 1) on up to count threads. Task 0 runs on
+// the calling thread. If a worker cannot be started its task runs inline as
+// well, so the work is never left half done
+template <typename Task>
+void RunInParallel(std::size_t count, Task task) {
+    std::vector<std::thread> workers;
+    workers.reserve(count);
+    for (std::size_t index = 1; index < count; ++index) {
+        try {
+            workers.emplace_back(task, index);
+        } catch (const std::system_error&) {
+            task(index);
+        }
+    }
+    task(0);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+template <typename T, typename Allocator = std::allocator<T>, typename Storage = StableNodes>
 class List {
+    static constexpr std::size_t kInlineNodes = InlineCapacity<Storage>::value;
+
+    static_assert(std::is_same<Storage, StableNodes>::value ||
+                      (kInlineNodes > 0 && kInlineNodes <= 64),
+                  "Unknown List storage policy");
+    static_assert(kInlineNodes == 0 || std::is_nothrow_move_constructible<T>::value,
+                  "Inline nodes are relocated on move and swap");
+
+private:
+    struct BaseNode {
+        BaseNode* prev = this;
+        BaseNode* next = this;
+    };
+
+    struct Node : BaseNode {
+        template <typename... Args>
+        explicit Node(Args&&... args) : value(std::forward<Args>(args)...) {
+        }
+
+        T value;
+    };
+
+    template <bool IsConst>
+    class Iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+
+        Iterator() = default;
+
+        template <bool WasConst, typename = std::enable_if_t<IsConst && !WasConst>>
+        Iterator(const Iterator<WasConst>& other) noexcept : node_(other.node_) {  // NOLINT
+        }
+
+        reference operator*() const {
+            return static_cast<node_pointer>(node_)->value;
+        }
+        pointer operator->() const {
+            return std::addressof(static_cast<node_pointer>(node_)->value);
+        }
+
+        Iterator& operator++() {
+            node_ = node_->next;
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator copy(*this);
+            ++*this;
+            return copy;
+        }
+        Iterator& operator--() {
+            node_ = node_->prev;
+            return *this;
+        }
+        Iterator operator--(int) {
+            Iterator copy(*this);
+            --*this;
+            return copy;
+        }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+            return lhs.node_ == rhs.node_;
+        }
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+            return lhs.node_ != rhs.node_;
+        }
+
+    private:
+        friend class List;
+        template <bool>
+        friend class Iterator;
+
+        using base_pointer = std::conditional_t<IsConst, const BaseNode*, BaseNode*>;
+        using node_pointer = std::conditional_t<IsConst, const Node*, Node*>;
+
+        explicit Iterator(base_pointer node) : node_(node) {
+        }
+
+        base_pointer node_ = nullptr;
+    };
+
+    using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+    using node_traits = std::allocator_traits<node_allocator>;
+
+    struct NoInlineSlots {};
+
+    // Raw storage for the inline nodes, bit i of used is set while slot i
+    // holds a node
+    struct InlineSlots {
+        struct alignas(Node) Slot {
+            unsigned char bytes[sizeof(Node)];
+        };
+
+        Slot slots[kInlineNodes];
+        uint64_t used = 0;
+    };
 
 public:
     using value_type = T;
-    // Your code goes here
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = typename std::allocator_traits<Allocator>::pointer;
+    using const_pointer = typename std::allocator_traits<Allocator>::const_pointer;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
     // Special member functions
     List(){};
 
-    List(const List& other) {
-        // Your code goes here
+    explicit List(const Allocator& alloc) : alloc_(alloc) {
+    }
+
+    List(const List& other)
+        : alloc_(node_traits::select_on_container_copy_construction(other.alloc_)) {
+        InsertRange(End(), other.Begin(), other.End());
     }
     List(const List& other, const Allocator& alloc);
 
@@ -55,7 +230,7 @@ public:
 
     void PushBack(const T& value);
     void PushBack(T&& value);
-    
+
     template <typename... Args>
     void EmplaceBack(Args&&... args);
     void PopBack();
@@ -67,15 +242,878 @@ public:
 
     void Resize(size_type count);
 
+    // Inserts copies of [first, last) before pos and returns an iterator to the
+    // first of them. Nodes for a forward range are requested from the allocator
+    // in batches. If an exception is thrown the list is left unchanged
+    template <typename InputIt>
+    iterator InsertRange(iterator pos, InputIt first, InputIt last);
+
     // Operations
+
+    // Moves elements of other before pos by relinking their nodes. O(1) except
+    // for a range taken from another list, which is counted to keep Size() O(1).
+    // If the allocators compare unequal the elements are moved into new nodes
+    void Splice(iterator pos, List& other);
+    void Splice(iterator pos, List&& other);
+    void Splice(iterator pos, List& other, iterator it);
+    void Splice(iterator pos, List& other, iterator first, iterator last);
+
+    // Merges the sorted other into this sorted list and leaves other empty.
+    // Stable: of equal elements those of this list come first
+    void Merge(List& other);
+    void Merge(List&& other);
+
     void Remove(const T& value);
     void Unique();
+    // Stable merge sort which relinks nodes: no element is copied, moved or
+    // allocated. O(n log n) comparisons, O(1) extra memory
     void Sort();
+    // Sorts runs of the list on up to threads workers and merges them pairwise,
+    // threads == 0 means one per hardware thread. operator< must not throw
+    void ParallelSort(size_type threads = 0);
 
     allocator_type GetAllocator() const noexcept;
 
 private:
-    // Your code goes here
+    template <typename... Args>
+    Node* CreateNode(Args&&... args);
+    void DestroyNode(BaseNode* node) noexcept;
+
+    // Unconstructed nodes come from a free inline slot if there is one and from
+    // the allocator otherwise. AllocateNodes batches allocator requests
+    Node* AllocateNode();
+    void AllocateNodes(Node** nodes, size_type count);
+    void DeallocateNode(Node* node) noexcept;
+
+    Node* InlineSlot(size_type slot) noexcept;
+    // Index of the inline slot holding node, kInlineNodes for allocated nodes
+    size_type InlineSlotOf(const BaseNode* node) const noexcept;
+
+    // Moves the element of from into unconstructed storage at to, which takes
+    // over the position of from in its chain
+    static void Relocate(node_allocator& alloc, BaseNode* from, Node* to) noexcept;
+    // Moves the inline elements of [first, last) into allocated nodes, so the
+    // nodes can be linked into another list. Returns the new first node
+    BaseNode* EvictInline(BaseNode* first, BaseNode* last);
+    void EvictInline();
+
+    template <typename... Args>
+    void EmplaceBefore(BaseNode* pos, Args&&... args);
+    void Erase(BaseNode* node) noexcept;
+    void Erase(BaseNode* first, BaseNode* last) noexcept;
+
+    // Moves the nodes of other into this empty list, leaving other empty
+    void StealNodes(List& other) noexcept;
+
+    // Re-anchors the chain hanging off src at dst, src becomes an empty ring
+    static void TakeLinks(BaseNode& dst, BaseNode& src) noexcept;
+    static void Link(BaseNode* pos, BaseNode* node) noexcept;
+    static void Unlink(BaseNode* node) noexcept;
+    // Relinks the nodes of [first, last) before pos, which lies outside of them
+    static void Transfer(BaseNode* pos, BaseNode* first, BaseNode* last) noexcept;
+
+    void RestoreLinks(BaseNode* head) noexcept;
+    // Sort and merge in place. If a comparison throws, every node is left in
+    // head or left as one unsorted chain, so that the list can be relinked
+    static void SortChain(BaseNode*& head);
+    static void MergeChains(BaseNode*& left, BaseNode*& right);
+    // Appends second to first and returns the joined chain
+    static BaseNode* Concatenate(BaseNode* first, BaseNode* second) noexcept;
+
+    // Shorter lists are not worth a thread
+    static constexpr size_type kMinParallelRun = 1 << 14;
+    // Nodes requested from the allocator by a single InsertRange batch
+    static constexpr size_type kInsertBatch = 64;
+
+    BaseNode sentinel_;
+    size_type size_ = 0;
+    node_allocator alloc_;
+    std::conditional_t<kInlineNodes == 0, NoInlineSlots, InlineSlots> inline_;
 };
 
-}  // namespace task
\ No newline at end of file
+template <typename T, typename Allocator, typename Storage>
+List<T, Allocator, Storage>::List(const List& other, const Allocator& alloc) : alloc_(alloc) {
+    InsertRange(End(), other.Begin(), other.End());
+}
+
+template <typename T, typename Allocator, typename Storage>
+List<T, Allocator, Storage>::List(List&& other) : alloc_(std::move(other.alloc_)) {
+    StealNodes(other);
+}
+
+template <typename T, typename Allocator, typename Storage>
+List<T, Allocator, Storage>::List(List&& other, const Allocator& alloc) : alloc_(alloc) {
+    if (alloc_ == other.alloc_) {
+        StealNodes(other);
+    } else {
+        InsertRange(End(), std::make_move_iterator(other.Begin()),
+                    std::make_move_iterator(other.End()));
+        other.Clear();
+    }
+}
+
+template <typename T, typename Allocator, typename Storage>
+List<T, Allocator, Storage>::~List() {
+    Clear();
+}
+
+template <typename T, typename Allocator, typename Storage>
+List<T, Allocator, Storage>& List<T, Allocator, Storage>::operator=(const List& other) {
+    if (this == &other) {
+        return *this;
+    }
+    Clear();
+    if (node_traits::propagate_on_container_copy_assignment::value) {
+        alloc_ = other.alloc_;
+    }
+    InsertRange(End(), other.Begin(), other.End());
+    return *this;
+}
+
+template <typename T, typename Allocator, typename Storage>
+List<T, Allocator, Storage>& List<T, Allocator, Storage>::operator=(List&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    Clear();
+    if (node_traits::propagate_on_container_move_assignment::value) {
+        alloc_ = std::move(other.alloc_);
+        StealNodes(other);
+    } else if (alloc_ == other.alloc_) {
+        StealNodes(other);
+    } else {
+        InsertRange(End(), std::make_move_iterator(other.Begin()),
+                    std::make_move_iterator(other.End()));
+        other.Clear();
+    }
+    return *this;
+}
+
+// Element access
+template <typename T, typename Allocator, typename Storage>
+typename List<T, Allocator, Storage>::reference List<T, Allocator, Storage>::Front() {
+    return *Begin();
+}
+
+template <typename T, typename Allocator, typename Storage>
+typename List<T, Allocator, Storage>::const_reference List<T, Allocator, Storage>::Front() const {
+    return *Begin();
+}
+
+template <typename T, typename Allocator, typename Storage>
+typename List<T, Allocator, Storage>::reference List<T, Allocator, Storage>::Back() {
+    return *--End();
+}
+
+template <typename T, typename Allocator, typename Storage>
+typename List<T, Allocator, Storage>::const_reference List<T, Allocator, Storage>::Back() const {
+    return *--End();
+}
+
+// Iterators
+template <typename T, typename Allocator, typename Storage>
+typename List<T, Allocator, Storage>::iterator List<T, Allocator, Storage>::Begin() noexcept {
+    return iterator(sentinel_.next);
+}
+
+template <typename T, typename Allocator, typename Storage>
+typename List<T, Allocator, Storage>::const_iterator List<T, Allocator, Storage>::Begin() const
+    noexcept {
+    return const_iterator(sentinel_.next);
+}
+
+template <typename T, typename Allocator, typename Storage>
+typename List<T, Allocator, Storage>::iterator List<T, Allocator, Storage>::End() noexcept {
+    return iterator(&sentinel_);
+}
+
+template <typename T, typename Allocator, typename Storage>
+typename List<T, Allocator, Storage>::const_iterator List<T, Allocator, Storage>::End() const
+    noexcept {
+    return const_iterator(&sentinel_);
+}
+
+// Capacity
+template <typename T, typename Allocator, typename Storage>
+bool List<T, Allocator, Storage>::Empty() const noexcept {
+    return size_ == 0;
+}
+
+template <typename T, typename Allocator, typename Storage>
+typename List<T, Allocator, Storage>::size_type List<T, Allocator, Storage>::Size() const noexcept {
+    return size_;
+}
+
+template <typename T, typename Allocator, typename Storage>
+typename List<T, Allocator, Storage>::size_type List<T, Allocator, Storage>::MaxSize() const
+    noexcept {
+    return node_traits::max_size(alloc_);
+}
+
+// Modifiers
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::Clear() {
+    BaseNode* node = sentinel_.next;
+    while (node != &sentinel_) {
+        BaseNode* next = node->next;
+        DestroyNode(node);
+        node = next;
+    }
+    sentinel_.next = sentinel_.prev = &sentinel_;
+    size_ = 0;
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::Swap(List& other) noexcept {
+    if (node_traits::propagate_on_container_swap::value) {
+        std::swap(alloc_, other.alloc_);
+    }
+    BaseNode tmp;
+    TakeLinks(tmp, sentinel_);
+    TakeLinks(sentinel_, other.sentinel_);
+    TakeLinks(other.sentinel_, tmp);
+    std::swap(size_, other.size_);
+
+    if constexpr (kInlineNodes > 0) {
+        // Inline nodes now belong to the chain of the other list, exchange them
+        // slot by slot
+        typename InlineSlots::Slot spare;
+        auto spare_node = reinterpret_cast<Node*>(&spare);
+        for (size_type slot = 0; slot < kInlineNodes; ++slot) {
+            bool mine = (inline_.used >> slot & 1) != 0;
+            bool theirs = (other.inline_.used >> slot & 1) != 0;
+            if (mine && theirs) {
+                Relocate(alloc_, InlineSlot(slot), spare_node);
+                Relocate(alloc_, other.InlineSlot(slot), InlineSlot(slot));
+                Relocate(alloc_, spare_node, other.InlineSlot(slot));
+            } else if (mine) {
+                Relocate(alloc_, InlineSlot(slot), other.InlineSlot(slot));
+            } else if (theirs) {
+                Relocate(alloc_, other.InlineSlot(slot), InlineSlot(slot));
+            }
+        }
+        std::swap(inline_.used, other.inline_.used);
+    }
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::PushBack(const T& value) {
+    EmplaceBefore(&sentinel_, value);
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::PushBack(T&& value) {
+    EmplaceBefore(&sentinel_, std::move(value));
+}
+
+template <typename T, typename Allocator, typename Storage>
+template <typename... Args>
+void List<T, Allocator, Storage>::EmplaceBack(Args&&... args) {
+    EmplaceBefore(&sentinel_, std::forward<Args>(args)...);
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::PopBack() {
+    Erase(sentinel_.prev);
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::PushFront(const T& value) {
+    EmplaceBefore(sentinel_.next, value);
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::PushFront(T&& value) {
+    EmplaceBefore(sentinel_.next, std::move(value));
+}
+
+template <typename T, typename Allocator, typename Storage>
+template <typename... Args>
+void List<T, Allocator, Storage>::EmplaceFront(Args&&... args) {
+    EmplaceBefore(sentinel_.next, std::forward<Args>(args)...);
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::PopFront() {
+    Erase(sentinel_.next);
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::Resize(size_type count) {
+    while (size_ > count) {
+        PopBack();
+    }
+    while (size_ < count) {
+        EmplaceBack();
+    }
+}
+
+template <typename T, typename Allocator, typename Storage>
+template <typename InputIt>
+typename List<T, Allocator, Storage>::iterator List<T, Allocator, Storage>::InsertRange(
+    iterator pos, InputIt first, InputIt last) {
+    // New nodes are chained off a local sentinel and linked in all at once
+    BaseNode chain;
+    size_type count = 0;
+    try {
+        using category = typename std::iterator_traits<InputIt>::iterator_category;
+        if constexpr (std::is_base_of<std::forward_iterator_tag, category>::value) {
+            Node* batch[kInsertBatch];
+            auto remaining = static_cast<size_type>(std::distance(first, last));
+            while (remaining > 0) {
+                size_type batch_size = std::min(remaining, kInsertBatch);
+                AllocateNodes(batch, batch_size);
+                for (size_type i = 0; i < batch_size; ++i, ++first) {
+                    try {
+                        node_traits::construct(alloc_, batch[i], *first);
+                    } catch (...) {
+                        for (; i < batch_size; ++i) {
+                            DeallocateNode(batch[i]);
+                        }
+                        throw;
+                    }
+                    Link(&chain, batch[i]);
+                }
+                count += batch_size;
+                remaining -= batch_size;
+            }
+        } else {
+            for (; first != last; ++first, ++count) {
+                Link(&chain, CreateNode(*first));
+            }
+        }
+    } catch (...) {
+        while (chain.next != &chain) {
+            BaseNode* node = chain.next;
+            Unlink(node);
+            DestroyNode(node);
+        }
+        throw;
+    }
+
+    if (count == 0) {
+        return pos;
+    }
+    iterator inserted(chain.next);
+    Transfer(pos.node_, chain.next, &chain);
+    size_ += count;
+    return inserted;
+}
+
+// Operations
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::Splice(iterator pos, List& other) {
+    if (&other == this || other.Empty()) {
+        return;
+    }
+    if (alloc_ == other.alloc_) {
+        other.EvictInline();
+        Transfer(pos.node_, other.sentinel_.next, &other.sentinel_);
+        size_ += other.size_;
+        other.size_ = 0;
+    } else {
+        InsertRange(pos, std::make_move_iterator(other.Begin()),
+                    std::make_move_iterator(other.End()));
+        other.Clear();
+    }
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::Splice(iterator pos, List&& other) {
+    Splice(pos, other);
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::Splice(iterator pos, List& other, iterator it) {
+    Splice(pos, other, it, std::next(it));
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::Splice(iterator pos, List& other, iterator first,
+                                         iterator last) {
+    if (first == last) {
+        return;
+    }
+    if (&other == this) {
+        Transfer(pos.node_, first.node_, last.node_);
+    } else if (alloc_ == other.alloc_) {
+        auto count = static_cast<size_type>(std::distance(first, last));
+        Transfer(pos.node_, other.EvictInline(first.node_, last.node_), last.node_);
+        size_ += count;
+        other.size_ -= count;
+    } else {
+        InsertRange(pos, std::make_move_iterator(first), std::make_move_iterator(last));
+        other.Erase(first.node_, last.node_);
+    }
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::Merge(List& other) {
+    if (&other == this || other.Empty()) {
+        return;
+    }
+    if (!(alloc_ == other.alloc_)) {
+        List moved(std::move(other), GetAllocator());
+        Merge(moved);
+        return;
+    }
+    other.EvictInline();
+    // Every run of other which sorts before node is relinked in one step. A
+    // throwing comparison leaves both lists valid
+    BaseNode* node = sentinel_.next;
+    while (other.size_ > 0) {
+        BaseNode* first = other.sentinel_.next;
+        BaseNode* last = first;
+        size_type count = 0;
+        if (node == &sentinel_) {
+            last = &other.sentinel_;
+            count = other.size_;
+        } else {
+            const T& value = static_cast<Node*>(node)->value;
+            while (last != &other.sentinel_ && static_cast<Node*>(last)->value < value) {
+                last = last->next;
+                ++count;
+            }
+        }
+        Transfer(node, first, last);
+        size_ += count;
+        other.size_ -= count;
+        if (node != &sentinel_) {
+            node = node->next;
+        }
+    }
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::Merge(List&& other) {
+    Merge(other);
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::Remove(const T& value) {
+    // value may refer to an element of the list, so that node is erased last
+    BaseNode* deferred = nullptr;
+    BaseNode* node = sentinel_.next;
+    while (node != &sentinel_) {
+        BaseNode* next = node->next;
+        const T& current = static_cast<Node*>(node)->value;
+        if (current == value) {
+            if (std::addressof(current) == std::addressof(value)) {
+                deferred = node;
+            } else {
+                Erase(node);
+            }
+        }
+        node = next;
+    }
+    if (deferred != nullptr) {
+        Erase(deferred);
+    }
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::Unique() {
+    if (size_ < 2) {
+        return;
+    }
+    BaseNode* node = sentinel_.next;
+    while (node->next != &sentinel_) {
+        BaseNode* next = node->next;
+        if (static_cast<Node*>(node)->value == static_cast<Node*>(next)->value) {
+            Erase(next);
+        } else {
+            node = next;
+        }
+    }
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::Sort() {
+    if (size_ < 2) {
+        return;
+    }
+    // Sort the chain as a singly linked list, then restore the prev links
+    sentinel_.prev->next = nullptr;
+    BaseNode* head = sentinel_.next;
+    try {
+        SortChain(head);
+    } catch (...) {
+        RestoreLinks(head);
+        throw;
+    }
+    RestoreLinks(head);
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::ParallelSort(size_type threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, size_ / kMinParallelRun);
+    if (threads < 2) {
+        Sort();
+        return;
+    }
+
+    // Cut the chain into one run per worker
+    sentinel_.prev->next = nullptr;
+    std::vector<BaseNode*> runs(threads);
+    BaseNode* node = sentinel_.next;
+    for (size_type run = 0; run < threads; ++run) {
+        runs[run] = node;
+        size_type length = size_ / threads + (run < size_ % threads ? 1 : 0);
+        for (size_type i = 1; i < length; ++i) {
+            node = node->next;
+        }
+        BaseNode* next = node->next;
+        node->next = nullptr;
+        node = next;
+    }
+
+    // Sort every run, then merge neighbours pairwise until one run is left
+    RunInParallel(runs.size(), [&runs](size_type run) { SortChain(runs[run]); });
+    while (runs.size() > 1) {
+        size_type pairs = runs.size() / 2;
+        RunInParallel(pairs, [&runs](size_type pair) {
+            MergeChains(runs[2 * pair], runs[2 * pair + 1]);
+        });
+        for (size_type pair = 0; pair < pairs; ++pair) {
+            runs[pair] = runs[2 * pair];
+        }
+        if (runs.size() % 2 == 1) {
+            runs[pairs] = runs.back();
+        }
+        runs.resize((runs.size() + 1) / 2);
+    }
+    RestoreLinks(runs.front());
+}
+
+template <typename T, typename Allocator, typename Storage>
+typename List<T, Allocator, Storage>::allocator_type List<T, Allocator, Storage>::GetAllocator()
+    const noexcept {
+    return allocator_type(alloc_);
+}
+
+// Implementation details
+template <typename T, typename Allocator, typename Storage>
+template <typename... Args>
+typename List<T, Allocator, Storage>::Node* List<T, Allocator, Storage>::CreateNode(
+    Args&&... args) {
+    Node* node = AllocateNode();
+    try {
+        node_traits::construct(alloc_, node, std::forward<Args>(args)...);
+    } catch (...) {
+        DeallocateNode(node);
+        throw;
+    }
+    return node;
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::DestroyNode(BaseNode* node) noexcept {
+    Node* p = static_cast<Node*>(node);
+    node_traits::destroy(alloc_, p);
+    DeallocateNode(p);
+}
+
+template <typename T, typename Allocator, typename Storage>
+typename List<T, Allocator, Storage>::Node* List<T, Allocator, Storage>::AllocateNode() {
+    if constexpr (kInlineNodes > 0) {
+        for (size_type slot = 0; slot < kInlineNodes; ++slot) {
+            if ((inline_.used >> slot & 1) == 0) {
+                inline_.used |= uint64_t{1} << slot;
+                return InlineSlot(slot);
+            }
+        }
+    }
+    return node_traits::allocate(alloc_, 1);
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::AllocateNodes(Node** nodes, size_type count) {
+    size_type taken = 0;
+    if constexpr (kInlineNodes > 0) {
+        for (size_type slot = 0; slot < kInlineNodes && taken < count; ++slot) {
+            if ((inline_.used >> slot & 1) == 0) {
+                inline_.used |= uint64_t{1} << slot;
+                nodes[taken++] = InlineSlot(slot);
+            }
+        }
+    }
+    try {
+        if constexpr (HasAllocateBatch<node_allocator>::value) {
+            if (taken < count) {
+                alloc_.allocate_batch(nodes + taken, count - taken);
+                taken = count;
+            }
+        } else {
+            for (; taken < count; ++taken) {
+                nodes[taken] = node_traits::allocate(alloc_, 1);
+            }
+        }
+    } catch (...) {
+        while (taken > 0) {
+            DeallocateNode(nodes[--taken]);
+        }
+        throw;
+    }
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::DeallocateNode(Node* node) noexcept {
+    if constexpr (kInlineNodes > 0) {
+        size_type slot = InlineSlotOf(node);
+        if (slot < kInlineNodes) {
+            inline_.used &= ~(uint64_t{1} << slot);
+            return;
+        }
+    }
+    node_traits::deallocate(alloc_, node, 1);
+}
+
+template <typename T, typename Allocator, typename Storage>
+typename List<T, Allocator, Storage>::Node* List<T, Allocator, Storage>::InlineSlot(
+    size_type slot) noexcept {
+    return reinterpret_cast<Node*>(&inline_.slots[slot]);
+}
+
+template <typename T, typename Allocator, typename Storage>
+typename List<T, Allocator, Storage>::size_type List<T, Allocator, Storage>::InlineSlotOf(
+    const BaseNode* node) const noexcept {
+    if constexpr (kInlineNodes > 0) {
+        auto address = reinterpret_cast<std::uintptr_t>(node);
+        auto begin = reinterpret_cast<std::uintptr_t>(&inline_.slots[0]);
+        if (address >= begin && address < begin + sizeof(inline_.slots)) {
+            return (address - begin) / sizeof(typename InlineSlots::Slot);
+        }
+    }
+    return kInlineNodes;
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::Relocate(node_allocator& alloc, BaseNode* from,
+                                           Node* to) noexcept {
+    Node* source = static_cast<Node*>(from);
+    node_traits::construct(alloc, to, std::move(source->value));
+    to->prev = from->prev;
+    to->next = from->next;
+    to->prev->next = to;
+    to->next->prev = to;
+    node_traits::destroy(alloc, source);
+}
+
+template <typename T, typename Allocator, typename Storage>
+typename List<T, Allocator, Storage>::BaseNode* List<T, Allocator, Storage>::EvictInline(
+    BaseNode* first, BaseNode* last) {
+    if constexpr (kInlineNodes > 0) {
+        BaseNode* head = first->prev;
+        for (; first != last && inline_.used != 0; first = first->next) {
+            size_type slot = InlineSlotOf(first);
+            if (slot < kInlineNodes) {
+                Node* node = node_traits::allocate(alloc_, 1);
+                Relocate(alloc_, first, node);
+                inline_.used &= ~(uint64_t{1} << slot);
+                first = node;
+            }
+        }
+        return head->next;
+    }
+    return first;
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::EvictInline() {
+    if constexpr (kInlineNodes > 0) {
+        for (size_type slot = 0; slot < kInlineNodes; ++slot) {
+            if ((inline_.used >> slot & 1) != 0) {
+                Node* node = node_traits::allocate(alloc_, 1);
+                Relocate(alloc_, InlineSlot(slot), node);
+                inline_.used &= ~(uint64_t{1} << slot);
+            }
+        }
+    }
+}
+
+template <typename T, typename Allocator, typename Storage>
+template <typename... Args>
+void List<T, Allocator, Storage>::EmplaceBefore(BaseNode* pos, Args&&... args) {
+    Link(pos, CreateNode(std::forward<Args>(args)...));
+    ++size_;
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::Erase(BaseNode* node) noexcept {
+    Unlink(node);
+    DestroyNode(node);
+    --size_;
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::Erase(BaseNode* first, BaseNode* last) noexcept {
+    while (first != last) {
+        BaseNode* next = first->next;
+        Erase(first);
+        first = next;
+    }
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::StealNodes(List& other) noexcept {
+    TakeLinks(sentinel_, other.sentinel_);
+    size_ = other.size_;
+    other.size_ = 0;
+
+    if constexpr (kInlineNodes > 0) {
+        // This list is empty, so every inline node of other fits the same slot here
+        for (size_type slot = 0; slot < kInlineNodes; ++slot) {
+            if ((other.inline_.used >> slot & 1) != 0) {
+                Relocate(alloc_, other.InlineSlot(slot), InlineSlot(slot));
+            }
+        }
+        inline_.used = other.inline_.used;
+        other.inline_.used = 0;
+    }
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::TakeLinks(BaseNode& dst, BaseNode& src) noexcept {
+    if (src.next == &src) {
+        dst.next = dst.prev = &dst;
+        return;
+    }
+    dst.next = src.next;
+    dst.prev = src.prev;
+    dst.next->prev = &dst;
+    dst.prev->next = &dst;
+    src.next = src.prev = &src;
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::Link(BaseNode* pos, BaseNode* node) noexcept {
+    node->next = pos;
+    node->prev = pos->prev;
+    pos->prev->next = node;
+    pos->prev = node;
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::Unlink(BaseNode* node) noexcept {
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::Transfer(BaseNode* pos, BaseNode* first,
+                                           BaseNode* last) noexcept {
+    if (first == last || pos == last) {
+        return;
+    }
+    BaseNode* tail = last->prev;
+    first->prev->next = last;
+    last->prev = first->prev;
+
+    first->prev = pos->prev;
+    tail->next = pos;
+    pos->prev->next = first;
+    pos->prev = tail;
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::RestoreLinks(BaseNode* head) noexcept {
+    BaseNode* prev = &sentinel_;
+    for (BaseNode* node = head; node != nullptr; node = node->next) {
+        prev->next = node;
+        node->prev = prev;
+        prev = node;
+    }
+    prev->next = &sentinel_;
+    sentinel_.prev = prev;
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::SortChain(BaseNode*& head) {
+    // Bottom-up merge sort: bins[i] is empty or holds a sorted run of 2^i
+    // nodes, all of which precede the nodes of the lower bins
+    BaseNode* bins[std::numeric_limits<size_type>::digits] = {};
+    size_type used = 0;
+    BaseNode* run = nullptr;
+    try {
+        while (head != nullptr) {
+            run = head;
+            head = head->next;
+            run->next = nullptr;
+
+            size_type bin = 0;
+            for (; bin < used && bins[bin] != nullptr; ++bin) {
+                MergeChains(bins[bin], run);
+                run = std::exchange(bins[bin], nullptr);
+            }
+            if (bin == used) {
+                ++used;
+            }
+            bins[bin] = std::exchange(run, nullptr);
+        }
+
+        for (size_type bin = 0; bin < used; ++bin) {
+            if (bins[bin] != nullptr) {
+                if (run != nullptr) {
+                    MergeChains(bins[bin], run);
+                }
+                run = std::exchange(bins[bin], nullptr);
+            }
+        }
+    } catch (...) {
+        // A failed merge leaves its nodes in the bin, gather everything back
+        head = Concatenate(run, head);
+        for (size_type bin = 0; bin < used; ++bin) {
+            head = Concatenate(bins[bin], head);
+        }
+        throw;
+    }
+    head = run;
+}
+
+template <typename T, typename Allocator, typename Storage>
+void List<T, Allocator, Storage>::MergeChains(BaseNode*& left, BaseNode*& right) {
+    // Ties are taken from the left run, so the sort is stable
+    BaseNode merged;
+    BaseNode* tail = &merged;
+    try {
+        while (left != nullptr && right != nullptr) {
+            if (static_cast<Node*>(right)->value < static_cast<Node*>(left)->value) {
+                tail->next = right;
+                right = right->next;
+            } else {
+                tail->next = left;
+                left = left->next;
+            }
+            tail = tail->next;
+        }
+    } catch (...) {
+        tail->next = Concatenate(left, right);
+        left = merged.next;
+        right = nullptr;
+        throw;
+    }
+    tail->next = left != nullptr ? left : right;
+    left = merged.next;
+    right = nullptr;
+}
+
+template <typename T, typename Allocator, typename Storage>
+typename List<T, Allocator, Storage>::BaseNode* List<T, Allocator, Storage>::Concatenate(
+    BaseNode* first, BaseNode* second) noexcept {
+    if (first == nullptr) {
+        return second;
+    }
+    BaseNode* tail = first;
+    while (tail->next != nullptr) {
+        tail = tail->next;
+    }
+    tail->next = second;
+    return first;
+}
+
+}  // namespace task
+
+#include "unrolled_list.h"
@@ -0,0 +1,826 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "list.h"
+
+namespace task {
+
+// Unrolled layout: elements are packed into cache-line aligned blocks of
+// BlockBytes, so a traversal touches one cache miss per block instead of one
+// per element. Blocks only grow at the ends of the list. InsertRange and
+// Splice link whole blocks in before pos, splitting its block first: the
+// elements from pos to the end of that block move into a new block, which
+// invalidates iterators to them. Remove, Unique, Merge and the sorts move
+// elements between slots and therefore invalidate all iterators
+template <typename T, typename Allocator, std::size_t BlockBytes>
+class List<T, Allocator, UnrolledBlocks<BlockBytes>> {
+private:
+    // Live elements of a block occupy [first, last). The sentinel is a bare
+    // header with first == last == 0
+    struct BlockHeader {
+        BlockHeader* prev = this;
+        BlockHeader* next = this;
+        uint32_t first = 0;
+        uint32_t last = 0;
+    };
+
+    static constexpr std::size_t kCapacity =
+        BlockBytes > sizeof(BlockHeader) + sizeof(T)
+            ? (BlockBytes - sizeof(BlockHeader)) / sizeof(T)
+            : 1;
+    static_assert(kCapacity <= std::numeric_limits<uint32_t>::max(), "Block is too large");
+
+    struct alignas(kCacheLineSize) Block : BlockHeader {
+        T* Data() noexcept {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+        const T* Data() const noexcept {
+            return std::launder(reinterpret_cast<const T*>(storage));
+        }
+
+        alignas(T) unsigned char storage[kCapacity * sizeof(T)];
+    };
+
+    template <bool IsConst>
+    class Iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+
+        Iterator() = default;
+
+        template <bool WasConst, typename = std::enable_if_t<IsConst && !WasConst>>
+        Iterator(const Iterator<WasConst>& other) noexcept  // NOLINT
+            : block_(other.block_), index_(other.index_) {
+        }
+
+        reference operator*() const {
+            return static_cast<block_pointer>(block_)->Data()[index_];
+        }
+        pointer operator->() const {
+            return static_cast<block_pointer>(block_)->Data() + index_;
+        }
+
+        Iterator& operator++() {
+            if (++index_ == block_->last) {
+                block_ = block_->next;
+                index_ = block_->first;
+            }
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator copy(*this);
+            ++*this;
+            return copy;
+        }
+        Iterator& operator--() {
+            if (index_ == block_->first) {
+                block_ = block_->prev;
+                index_ = block_->last;
+            }
+            --index_;
+            return *this;
+        }
+        Iterator operator--(int) {
+            Iterator copy(*this);
+            --*this;
+            return copy;
+        }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+            return lhs.block_ == rhs.block_ && lhs.index_ == rhs.index_;
+        }
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+            return !(lhs == rhs);
+        }
+
+    private:
+        friend class List;
+        template <bool>
+        friend class Iterator;
+
+        using header_pointer = std::conditional_t<IsConst, const BlockHeader*, BlockHeader*>;
+        using block_pointer = std::conditional_t<IsConst, const Block*, Block*>;
+
+        Iterator(header_pointer block, uint32_t index) : block_(block), index_(index) {
+        }
+
+        header_pointer block_ = nullptr;
+        uint32_t index_ = 0;
+    };
+
+    using block_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Block>;
+    using block_traits = std::allocator_traits<block_allocator>;
+
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = typename std::allocator_traits<Allocator>::pointer;
+    using const_pointer = typename std::allocator_traits<Allocator>::const_pointer;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_type kElementsPerBlock = kCapacity;
+
+    // Special member functions
+    List() = default;
+
+    explicit List(const Allocator& alloc) : alloc_(alloc) {
+    }
+
+    List(const List& other)
+        : alloc_(block_traits::select_on_container_copy_construction(other.alloc_)) {
+        Append(other.Begin(), other.End());
+    }
+    List(const List& other, const Allocator& alloc) : alloc_(alloc) {
+        Append(other.Begin(), other.End());
+    }
+
+    List(List&& other) : alloc_(std::move(other.alloc_)) {
+        StealBlocks(other);
+    }
+    List(List&& other, const Allocator& alloc) : alloc_(alloc) {
+        if (alloc_ == other.alloc_) {
+            StealBlocks(other);
+        } else {
+            Append(std::make_move_iterator(other.Begin()), std::make_move_iterator(other.End()));
+            other.Clear();
+        }
+    }
+
+    ~List() {
+        Clear();
+    }
+
+    List& operator=(const List& other);
+
+    List& operator=(List&& other) noexcept;
+
+    // Element access
+    reference Front() {
+        return *Begin();
+    }
+    const_reference Front() const {
+        return *Begin();
+    }
+    reference Back() {
+        return *--End();
+    }
+    const_reference Back() const {
+        return *--End();
+    }
+
+    // Iterators
+    iterator Begin() noexcept {
+        return iterator(sentinel_.next, sentinel_.next->first);
+    }
+    const_iterator Begin() const noexcept {
+        return const_iterator(sentinel_.next, sentinel_.next->first);
+    }
+
+    iterator End() noexcept {
+        return iterator(&sentinel_, 0);
+    }
+    const_iterator End() const noexcept {
+        return const_iterator(&sentinel_, 0);
+    }
+
+    // Capacity
+    bool Empty() const noexcept {
+        return size_ == 0;
+    }
+
+    size_type Size() const noexcept {
+        return size_;
+    }
+    size_type MaxSize() const noexcept {
+        return std::min(block_traits::max_size(alloc_),
+                        std::numeric_limits<size_type>::max() / kCapacity) *
+               kCapacity;
+    }
+
+    // Modifiers
+    void Clear();
+    void Swap(List& other) noexcept;
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    template <typename... Args>
+    void EmplaceBack(Args&&... args);
+    void PopBack();
+    void PushFront(const T& value) {
+        EmplaceFront(value);
+    }
+    void PushFront(T&& value) {
+        EmplaceFront(std::move(value));
+    }
+    template <typename... Args>
+    void EmplaceFront(Args&&... args);
+    void PopFront();
+
+    void Resize(size_type count);
+
+    // Inserts copies of [first, last) before pos and returns an iterator to the
+    // first of them. They get blocks of their own, so many small insertions
+    // leave the blocks sparse. If an exception is thrown the list is unchanged
+    template <typename InputIt>
+    iterator InsertRange(iterator pos, InputIt first, InputIt last);
+
+    // Operations
+
+    // Moves elements of other before pos by relinking their blocks. If the
+    // allocators compare unequal the elements are moved into new blocks
+    void Splice(iterator pos, List& other);
+    void Splice(iterator pos, List&& other);
+    void Splice(iterator pos, List& other, iterator it);
+    void Splice(iterator pos, List& other, iterator first, iterator last);
+
+    // Merges the sorted other into this sorted list and leaves other empty.
+    // Stable: of equal elements those of this list come first. If a comparison
+    // throws, the elements of other stay appended unmerged
+    void Merge(List& other);
+    void Merge(List&& other);
+
+    void Remove(const T& value);
+    void Unique();
+    // Stable. Sorts the positions of the elements and then moves each element
+    // into place, so a throwing comparison leaves the list unchanged
+    void Sort();
+    // Sorts parts of the list on up to threads workers and merges them
+    // pairwise, threads == 0 means one per hardware thread. operator< must not throw
+    void ParallelSort(size_type threads = 0);
+
+    allocator_type GetAllocator() const noexcept {
+        return allocator_type(alloc_);
+    }
+
+private:
+    Block* CreateBlock(BlockHeader* pos, uint32_t offset);
+    void DestroyBlock(BlockHeader* block) noexcept;
+
+    template <typename InputIt>
+    void Append(InputIt first, InputIt last);
+
+    // Makes pos the first element of a block and returns that block. The
+    // elements behind pos keep their slot indices in a new block
+    BlockHeader* SplitAt(iterator pos);
+    // An iterator to an element moved by SplitAt(split) follows it to block
+    static void Follow(iterator& it, iterator split, BlockHeader* block) noexcept;
+    // Moves the blocks [first, last) of this list to the end of other
+    void CutBlocks(BlockHeader* first, BlockHeader* last, List& other) noexcept;
+    // Moves all blocks of other before pos, which is a block of this list
+    void LinkBlocks(BlockHeader* pos, List& other) noexcept;
+
+    // sort(order, less) arranges the positions 0..Size()-1 of the elements,
+    // where less compares the elements at two positions. The elements are then
+    // moved into that order; nothing is moved if sort throws
+    template <typename SortOrder>
+    void SortByOrder(SortOrder sort);
+
+    // Removes every element from pos to the end of the list
+    void EraseFrom(iterator pos) noexcept;
+
+    // Keeps the elements for which keep(element, last kept element) holds,
+    // moving them towards the front without changing their order
+    template <typename Keep>
+    void Compact(Keep keep);
+
+    bool Contains(const T* p) const noexcept;
+
+    void StealBlocks(List& other) noexcept;
+    static void TakeLinks(BlockHeader& dst, BlockHeader& src) noexcept;
+
+    static T* Slot(BlockHeader* block, uint32_t index) noexcept {
+        return static_cast<Block*>(block)->Data() + index;
+    }
+
+    // Shorter lists are not worth a thread
+    static constexpr size_type kMinParallelRun = 1 << 14;
+
+    BlockHeader sentinel_;
+    size_type size_ = 0;
+    block_allocator alloc_;
+};
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+List<T, Allocator, UnrolledBlocks<BlockBytes>>& List<T, Allocator, UnrolledBlocks<BlockBytes>>::
+operator=(const List& other) {
+    if (this == &other) {
+        return *this;
+    }
+    Clear();
+    if (block_traits::propagate_on_container_copy_assignment::value) {
+        alloc_ = other.alloc_;
+    }
+    Append(other.Begin(), other.End());
+    return *this;
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+List<T, Allocator, UnrolledBlocks<BlockBytes>>& List<T, Allocator, UnrolledBlocks<BlockBytes>>::
+operator=(List&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    Clear();
+    if (block_traits::propagate_on_container_move_assignment::value) {
+        alloc_ = std::move(other.alloc_);
+        StealBlocks(other);
+    } else if (alloc_ == other.alloc_) {
+        StealBlocks(other);
+    } else {
+        Append(std::make_move_iterator(other.Begin()), std::make_move_iterator(other.End()));
+        other.Clear();
+    }
+    return *this;
+}
+
+// Modifiers
+template <typename T, typename Allocator, std::size_t BlockBytes>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::Clear() {
+    BlockHeader* block = sentinel_.next;
+    while (block != &sentinel_) {
+        BlockHeader* next = block->next;
+        std::destroy(Slot(block, block->first), Slot(block, block->last));
+        DestroyBlock(block);
+        block = next;
+    }
+    sentinel_.next = sentinel_.prev = &sentinel_;
+    size_ = 0;
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::Swap(List& other) noexcept {
+    if (block_traits::propagate_on_container_swap::value) {
+        std::swap(alloc_, other.alloc_);
+    }
+    BlockHeader tmp;
+    TakeLinks(tmp, sentinel_);
+    TakeLinks(sentinel_, other.sentinel_);
+    TakeLinks(other.sentinel_, tmp);
+    std::swap(size_, other.size_);
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+template <typename... Args>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::EmplaceBack(Args&&... args) {
+    BlockHeader* block = sentinel_.prev;
+    bool fresh = block == &sentinel_ || block->last == kCapacity;
+    if (fresh) {
+        block = CreateBlock(&sentinel_, 0);
+    }
+    try {
+        block_traits::construct(alloc_, Slot(block, block->last), std::forward<Args>(args)...);
+    } catch (...) {
+        if (fresh) {
+            DestroyBlock(block);
+        }
+        throw;
+    }
+    ++block->last;
+    ++size_;
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::PopBack() {
+    BlockHeader* block = sentinel_.prev;
+    --block->last;
+    block_traits::destroy(alloc_, Slot(block, block->last));
+    if (block->first == block->last) {
+        DestroyBlock(block);
+    }
+    --size_;
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+template <typename... Args>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::EmplaceFront(Args&&... args) {
+    BlockHeader* block = sentinel_.next;
+    bool fresh = block == &sentinel_ || block->first == 0;
+    if (fresh) {
+        // A block opened at the front fills from its end
+        block = CreateBlock(sentinel_.next, kCapacity);
+    }
+    try {
+        block_traits::construct(alloc_, Slot(block, block->first - 1),
+                                std::forward<Args>(args)...);
+    } catch (...) {
+        if (fresh) {
+            DestroyBlock(block);
+        }
+        throw;
+    }
+    --block->first;
+    ++size_;
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::PopFront() {
+    BlockHeader* block = sentinel_.next;
+    block_traits::destroy(alloc_, Slot(block, block->first));
+    ++block->first;
+    if (block->first == block->last) {
+        DestroyBlock(block);
+    }
+    --size_;
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::Resize(size_type count) {
+    while (size_ > count) {
+        PopBack();
+    }
+    while (size_ < count) {
+        EmplaceBack();
+    }
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+template <typename InputIt>
+typename List<T, Allocator, UnrolledBlocks<BlockBytes>>::iterator
+List<T, Allocator, UnrolledBlocks<BlockBytes>>::InsertRange(iterator pos, InputIt first,
+                                                            InputIt last) {
+    List inserted(GetAllocator());
+    inserted.Append(first, last);
+    if (inserted.Empty()) {
+        return pos;
+    }
+    BlockHeader* at = SplitAt(pos);
+    iterator result = inserted.Begin();
+    LinkBlocks(at, inserted);
+    return result;
+}
+
+// Operations
+template <typename T, typename Allocator, std::size_t BlockBytes>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::Splice(iterator pos, List& other) {
+    if (&other == this || other.Empty()) {
+        return;
+    }
+    BlockHeader* at = SplitAt(pos);
+    // Steals the blocks of other if the allocators are equal
+    List moved(std::move(other), GetAllocator());
+    LinkBlocks(at, moved);
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::Splice(iterator pos, List&& other) {
+    Splice(pos, other);
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::Splice(iterator pos, List& other,
+                                                            iterator it) {
+    Splice(pos, other, it, std::next(it));
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::Splice(iterator pos, List& other,
+                                                            iterator first, iterator last) {
+    if (first == last) {
+        return;
+    }
+    // Split at the ends of the range and at pos, so that the range is a run of
+    // whole blocks. When other is this list pos may sit behind a split point
+    BlockHeader* end = other.SplitAt(last);
+    Follow(pos, last, end);
+    BlockHeader* begin = other.SplitAt(first);
+    Follow(pos, first, begin);
+    BlockHeader* at = SplitAt(pos);
+
+    List moved(GetAllocator());
+    if (alloc_ == other.alloc_) {
+        other.CutBlocks(begin, end, moved);
+    } else {
+        moved.Append(std::make_move_iterator(iterator(begin, begin->first)),
+                     std::make_move_iterator(iterator(end, end->first)));
+        List taken(other.GetAllocator());
+        other.CutBlocks(begin, end, taken);
+    }
+    LinkBlocks(at, moved);
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::Merge(List& other) {
+    if (&other == this || other.Empty()) {
+        return;
+    }
+    // other is appended as a whole, then the positions of the two sorted
+    // halves are merged
+    List moved(std::move(other), GetAllocator());
+    size_type middle = size_;
+    LinkBlocks(&sentinel_, moved);
+    SortByOrder([middle](auto& order, auto less) {
+        std::inplace_merge(order.begin(), order.begin() + middle, order.end(), less);
+    });
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::Merge(List&& other) {
+    Merge(other);
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::Remove(const T& value) {
+    // Compaction overwrites removed slots, so an argument which refers to an
+    // element of the list is copied first
+    if (Contains(std::addressof(value))) {
+        T copy(value);
+        Compact([&copy](const T& element, const T*) { return !(element == copy); });
+    } else {
+        Compact([&value](const T& element, const T*) { return !(element == value); });
+    }
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::Unique() {
+    Compact([](const T& element, const T* kept) { return kept == nullptr || !(*kept == element); });
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::Sort() {
+    if (size_ < 2) {
+        return;
+    }
+    SortByOrder([](auto& order, auto less) { std::stable_sort(order.begin(), order.end(), less); });
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::ParallelSort(size_type threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, size_ / kMinParallelRun);
+    if (threads < 2) {
+        Sort();
+        return;
+    }
+
+    SortByOrder([threads](auto& order, auto less) {
+        // Part i of the order is [bounds[i], bounds[i + 1])
+        size_type size = order.size();
+        std::vector<size_type> bounds(threads + 1);
+        for (size_type part = 0; part <= threads; ++part) {
+            bounds[part] = size / threads * part + std::min(part, size % threads);
+        }
+        auto at = [&order, &bounds](size_type bound) { return order.begin() + bounds[bound]; };
+
+        RunInParallel(threads, [&at, less](size_type part) {
+            std::stable_sort(at(part), at(part + 1), less);
+        });
+        while (bounds.size() > 2) {
+            size_type pairs = (bounds.size() - 1) / 2;
+            RunInParallel(pairs, [&at, less](size_type pair) {
+                std::inplace_merge(at(2 * pair), at(2 * pair + 1), at(2 * pair + 2), less);
+            });
+            // Every other bound is gone, the last one always stays
+            size_type kept = 0;
+            for (size_type bound = 0; bound < bounds.size(); bound += 2) {
+                bounds[kept++] = bounds[bound];
+            }
+            if (bounds.size() % 2 == 0) {
+                bounds[kept++] = bounds.back();
+            }
+            bounds.resize(kept);
+        }
+    });
+}
+
+// Implementation details
+template <typename T, typename Allocator, std::size_t BlockBytes>
+typename List<T, Allocator, UnrolledBlocks<BlockBytes>>::Block*
+List<T, Allocator, UnrolledBlocks<BlockBytes>>::CreateBlock(BlockHeader* pos, uint32_t offset) {
+    Block* block = block_traits::allocate(alloc_, 1);
+    ::new (static_cast<void*>(block)) Block;
+    block->first = block->last = offset;
+    block->next = pos;
+    block->prev = pos->prev;
+    pos->prev->next = block;
+    pos->prev = block;
+    return block;
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::DestroyBlock(BlockHeader* header) noexcept {
+    header->prev->next = header->next;
+    header->next->prev = header->prev;
+    Block* block = static_cast<Block*>(header);
+    block->~Block();
+    block_traits::deallocate(alloc_, block, 1);
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+template <typename InputIt>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::Append(InputIt first, InputIt last) {
+    for (; first != last; ++first) {
+        EmplaceBack(*first);
+    }
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::EraseFrom(iterator pos) noexcept {
+    BlockHeader* block = pos.block_;
+    if (block == &sentinel_) {
+        return;
+    }
+    size_ -= block->last - pos.index_;
+    std::destroy(Slot(block, pos.index_), Slot(block, block->last));
+    block->last = pos.index_;
+
+    BlockHeader* next = block->next;
+    if (block->first == block->last) {
+        DestroyBlock(block);
+    }
+    while (next != &sentinel_) {
+        block = next;
+        next = block->next;
+        size_ -= block->last - block->first;
+        std::destroy(Slot(block, block->first), Slot(block, block->last));
+        DestroyBlock(block);
+    }
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+typename List<T, Allocator, UnrolledBlocks<BlockBytes>>::BlockHeader*
+List<T, Allocator, UnrolledBlocks<BlockBytes>>::SplitAt(iterator pos) {
+    BlockHeader* block = pos.block_;
+    if (pos.index_ == block->first) {
+        return block;
+    }
+    Block* tail = CreateBlock(block->next, pos.index_);
+    try {
+        for (; tail->last < block->last; ++tail->last) {
+            block_traits::construct(alloc_, Slot(tail, tail->last),
+                                    std::move_if_noexcept(*Slot(block, tail->last)));
+        }
+    } catch (...) {
+        std::destroy(Slot(tail, tail->first), Slot(tail, tail->last));
+        DestroyBlock(tail);
+        throw;
+    }
+    std::destroy(Slot(block, pos.index_), Slot(block, block->last));
+    block->last = pos.index_;
+    return tail;
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::Follow(iterator& it, iterator split,
+                                                            BlockHeader* block) noexcept {
+    if (it.block_ == split.block_ && it.index_ >= split.index_) {
+        it.block_ = block;
+    }
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::CutBlocks(BlockHeader* first,
+                                                               BlockHeader* last,
+                                                               List& other) noexcept {
+    size_type count = 0;
+    for (BlockHeader* block = first; block != last; block = block->next) {
+        count += block->last - block->first;
+    }
+    BlockHeader* back = last->prev;
+    first->prev->next = last;
+    last->prev = first->prev;
+
+    first->prev = other.sentinel_.prev;
+    back->next = &other.sentinel_;
+    other.sentinel_.prev->next = first;
+    other.sentinel_.prev = back;
+    size_ -= count;
+    other.size_ += count;
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::LinkBlocks(BlockHeader* pos,
+                                                                List& other) noexcept {
+    if (other.Empty()) {
+        return;
+    }
+    BlockHeader* first = other.sentinel_.next;
+    BlockHeader* last = other.sentinel_.prev;
+    first->prev = pos->prev;
+    last->next = pos;
+    pos->prev->next = first;
+    pos->prev = last;
+    other.sentinel_.next = other.sentinel_.prev = &other.sentinel_;
+    size_ += other.size_;
+    other.size_ = 0;
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+template <typename SortOrder>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::SortByOrder(SortOrder sort) {
+    // Only positions are sorted: a sort which throws from a comparison may
+    // destroy what it holds in its own buffer, and positions cost nothing to
+    // lose. The block structure is left untouched
+    using slot_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<T*>;
+    using order_allocator =
+        typename std::allocator_traits<Allocator>::template rebind_alloc<size_type>;
+    std::vector<T*, slot_allocator> slots{slot_allocator(alloc_)};
+    slots.reserve(size_);
+    for (iterator it = Begin(); it != End(); ++it) {
+        slots.push_back(std::addressof(*it));
+    }
+    std::vector<size_type, order_allocator> order(size_, 0, order_allocator(alloc_));
+    std::iota(order.begin(), order.end(), size_type{0});
+    sort(order, [&slots](size_type lhs, size_type rhs) { return *slots[lhs] < *slots[rhs]; });
+
+    // Position i receives the element at order[i]. Each cycle of the
+    // permutation is rotated through one temporary
+    for (size_type start = 0; start < size_; ++start) {
+        if (order[start] == start) {
+            continue;
+        }
+        T value(std::move(*slots[start]));
+        size_type position = start;
+        while (order[position] != start) {
+            size_type source = order[position];
+            *slots[position] = std::move(*slots[source]);
+            order[position] = position;
+            position = source;
+        }
+        *slots[position] = std::move(value);
+        order[position] = position;
+    }
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+template <typename Keep>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::Compact(Keep keep) {
+    iterator write = Begin();
+    const T* kept = nullptr;
+    for (iterator read = Begin(); read != End(); ++read) {
+        if (!keep(*read, kept)) {
+            continue;
+        }
+        if (write != read) {
+            *write = std::move(*read);
+        }
+        kept = std::addressof(*write);
+        ++write;
+    }
+    EraseFrom(write);
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+bool List<T, Allocator, UnrolledBlocks<BlockBytes>>::Contains(const T* p) const noexcept {
+    std::less<const T*> less;
+    for (const BlockHeader* block = sentinel_.next; block != &sentinel_; block = block->next) {
+        const T* data = static_cast<const Block*>(block)->Data();
+        if (!less(p, data + block->first) && less(p, data + block->last)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::StealBlocks(List& other) noexcept {
+    TakeLinks(sentinel_, other.sentinel_);
+    size_ = other.size_;
+    other.size_ = 0;
+}
+
+template <typename T, typename Allocator, std::size_t BlockBytes>
+void List<T, Allocator, UnrolledBlocks<BlockBytes>>::TakeLinks(BlockHeader& dst,
+                                                               BlockHeader& src) noexcept {
+    if (src.next == &src) {
+        dst.next = dst.prev = &dst;
+        return;
+    }
+    dst.next = src.next;
+    dst.prev = src.prev;
+    dst.next->prev = &dst;
+    dst.prev->next = &dst;
+    src.next = src.prev = &src;
+}
+
+}  // namespace task
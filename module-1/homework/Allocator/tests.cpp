@@ -1,10 +1,19 @@
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
 #include <list>
 #include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "src/allocator/allocator.h"
+#include "src/list/concurrent_list.h"
 #include "src/list/list.h"
 
 TEST(CopyAssignment, Test) {
@@ -259,6 +268,1040 @@ TEST(Mixed, Test1) {
     ASSERT_TRUE(std::equal(actual.Begin(), actual.End(), expected.begin(), expected.end()));
 }
 
+// Sort
+TEST(Sort, Stable) {
+    struct Entry {
+        int key;
+        int order;
+
+        bool operator<(const Entry& other) const {
+            return key < other.key;
+        }
+    };
+
+    std::mt19937 random_engine(42);
+    std::uniform_int_distribution<int> distribution(1, 10);
+    task::List<Entry, CustomAllocator<Entry>> actual;
+    for (int i = 0; i < 1000; i++) {
+        actual.PushBack({distribution(random_engine), i});
+    }
+    actual.Sort();
+    auto by_key_then_order = [](const Entry& lhs, const Entry& rhs) {
+        return lhs.key < rhs.key || (lhs.key == rhs.key && lhs.order < rhs.order);
+    };
+    ASSERT_TRUE(std::is_sorted(actual.Begin(), actual.End(), by_key_then_order));
+}
+
+TEST(Sort, SortedAndReversed) {
+    task::List<int> sorted;
+    task::List<int> reversed;
+    for (int i = 0; i < 1000; i++) {
+        sorted.PushBack(i);
+        reversed.PushFront(i);
+    }
+    sorted.Sort();
+    reversed.Sort();
+    ASSERT_TRUE(std::equal(sorted.Begin(), sorted.End(), reversed.Begin(), reversed.End()));
+    ASSERT_TRUE(std::is_sorted(reversed.Begin(), reversed.End()));
+    ASSERT_EQ(reversed.Back(), 999);
+}
+
+TEST(Sort, RelinksNodes) {
+    task::List<std::string, CustomAllocator<std::string>> actual;
+    for (std::size_t i = 0; i < 100; i++) {
+        actual.PushFront(std::to_string(i));
+    }
+    std::set<const std::string*> before;
+    for (auto it = actual.Begin(); it != actual.End(); ++it) {
+        before.insert(&*it);
+    }
+    actual.Sort();
+    std::set<const std::string*> after;
+    for (auto it = actual.Begin(); it != actual.End(); ++it) {
+        after.insert(&*it);
+    }
+    ASSERT_TRUE(before == after);
+    ASSERT_TRUE(std::is_sorted(actual.Begin(), actual.End()));
+}
+
+TEST(Sort, ThrowingComparison) {
+    static int comparisons_left = 0;
+    struct Fragile {
+        int value;
+
+        bool operator<(const Fragile& other) const {
+            if (--comparisons_left == 0) {
+                throw std::runtime_error("comparison failed");
+            }
+            return value < other.value;
+        }
+    };
+
+    // Fail at different points of the sort: inside a merge and between merges
+    for (int fail_at : {1, 2, 5, 37, 300, 500}) {
+        task::List<Fragile, CustomAllocator<Fragile>> actual;
+        for (int i = 0; i < 100; i++) {
+            actual.PushBack({(i * 37) % 100});
+        }
+        comparisons_left = fail_at;
+        ASSERT_THROW(actual.Sort(), std::runtime_error);
+
+        // Every element survives and the links are consistent both ways
+        ASSERT_EQ(actual.Size(), 100u);
+        std::vector<int> forward;
+        for (auto it = actual.Begin(); it != actual.End(); ++it) {
+            forward.push_back(it->value);
+        }
+        std::vector<int> backward;
+        for (auto it = actual.End(); it != actual.Begin();) {
+            backward.push_back((--it)->value);
+        }
+        ASSERT_TRUE(std::equal(forward.begin(), forward.end(), backward.rbegin(), backward.rend()));
+        std::sort(forward.begin(), forward.end());
+        for (int i = 0; i < 100; i++) {
+            ASSERT_EQ(forward[i], i);
+        }
+
+        comparisons_left = 0;
+        actual.Sort();
+        ASSERT_EQ(actual.Front().value, 0);
+        ASSERT_EQ(actual.Back().value, 99);
+    }
+}
+
+TEST(Sort, Parallel) {
+    std::mt19937 random_engine(42);
+    std::uniform_int_distribution<int> distribution;
+
+    task::List<int, CustomAllocator<int>> actual;
+    std::list<int> expected;
+    for (std::size_t i = 0; i < 100000; i++) {
+        int value = distribution(random_engine);
+        actual.PushBack(value);
+        expected.push_back(value);
+    }
+    actual.ParallelSort(4);
+    expected.sort();
+    ASSERT_EQ(actual.Size(), expected.size());
+    ASSERT_TRUE(std::equal(actual.Begin(), actual.End(), expected.begin(), expected.end()));
+    ASSERT_EQ(actual.Back(), expected.back());
+    actual.PopBack();
+    ASSERT_EQ(actual.Back(), *std::next(expected.rbegin()));
+}
+
+// Splice, InsertRange and Merge
+
+// Live objects allocated by TaggedAllocator under every id, shared by all rebinds
+std::size_t& TaggedLiveObjects(int id) {
+    static std::size_t live[4] = {};
+    return live[id];
+}
+
+// Stateful allocator, instances with different ids compare unequal
+template <typename T>
+class TaggedAllocator {
+public:
+    using value_type = T;
+
+    explicit TaggedAllocator(int id) : id_(id) {
+    }
+    template <typename U>
+    TaggedAllocator(const TaggedAllocator<U>& other) noexcept : id_(other.id_) {  // NOLINT
+    }
+
+    T* allocate(std::size_t n) {  // NOLINT
+        TaggedLiveObjects(id_) += n;
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, std::size_t n) {  // NOLINT
+        TaggedLiveObjects(id_) -= n;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const TaggedAllocator<U>& other) const noexcept {
+        return id_ == other.id_;
+    }
+    template <typename U>
+    bool operator!=(const TaggedAllocator<U>& other) const noexcept {
+        return id_ != other.id_;
+    }
+
+private:
+    template <typename U>
+    friend class TaggedAllocator;
+
+    int id_;
+};
+
+template <typename List>
+std::vector<typename List::value_type> Elements(const List& list) {
+    return std::vector<typename List::value_type>(list.Begin(), list.End());
+}
+
+TEST(Splice, WholeList) {
+    task::List<std::string, CustomAllocator<std::string>> actual;
+    task::List<std::string, CustomAllocator<std::string>> other;
+    actual.PushBack("a");
+    actual.PushBack("d");
+    other.PushBack("b");
+    other.PushBack("c");
+    const std::string* address = &other.Front();
+
+    actual.Splice(std::next(actual.Begin()), other);
+    ASSERT_TRUE(other.Empty());
+    ASSERT_EQ(actual.Size(), 4);
+    ASSERT_EQ(&*std::next(actual.Begin()), address);
+    ASSERT_EQ(Elements(actual), (std::vector<std::string>{"a", "b", "c", "d"}));
+
+    actual.Splice(actual.End(), std::move(other));
+    ASSERT_EQ(actual.Size(), 4);
+}
+
+TEST(Splice, Ranges) {
+    task::List<int> actual;
+    task::List<int> other;
+    for (int i = 0; i < 5; i++) {
+        actual.PushBack(i);
+        other.PushBack(10 + i);
+    }
+
+    actual.Splice(actual.Begin(), other, std::next(other.Begin()), std::prev(other.End()));
+    ASSERT_EQ(Elements(actual), (std::vector<int>{11, 12, 13, 0, 1, 2, 3, 4}));
+    ASSERT_EQ(Elements(other), (std::vector<int>{10, 14}));
+
+    actual.Splice(actual.End(), other, other.Begin());
+    ASSERT_EQ(actual.Back(), 10);
+    ASSERT_EQ(other.Size(), 1);
+
+    // Within one list: move the first three elements to the back
+    actual.Splice(actual.End(), actual, actual.Begin(), std::next(actual.Begin(), 3));
+    ASSERT_EQ(Elements(actual), (std::vector<int>{0, 1, 2, 3, 4, 10, 11, 12, 13}));
+    ASSERT_EQ(actual.Size(), 9);
+}
+
+TEST(Splice, CrossAllocator) {
+    using Allocator = TaggedAllocator<std::string>;
+    {
+        task::List<std::string, Allocator> actual(Allocator(1));
+        task::List<std::string, Allocator> other(Allocator(2));
+        for (std::size_t i = 0; i < 10; i++) {
+            actual.PushBack(std::to_string(i));
+            other.PushBack(std::to_string(10 + i));
+        }
+
+        // Nodes cannot change owners, the elements are moved into new nodes
+        actual.Splice(actual.End(), other, other.Begin(), std::next(other.Begin(), 3));
+        ASSERT_EQ(actual.Size(), 13);
+        ASSERT_EQ(other.Size(), 7);
+        ASSERT_EQ(TaggedLiveObjects(1), 13);
+        ASSERT_EQ(TaggedLiveObjects(2), 7);
+        ASSERT_EQ(actual.Back(), "12");
+
+        actual.Splice(actual.Begin(), other);
+        ASSERT_TRUE(other.Empty());
+        ASSERT_EQ(TaggedLiveObjects(1), 20);
+        ASSERT_EQ(TaggedLiveObjects(2), 0);
+        ASSERT_EQ(actual.Front(), "13");
+    }
+    ASSERT_EQ(TaggedLiveObjects(1), 0);
+}
+
+TEST(InsertRange, Test) {
+    std::vector<std::string> values;
+    for (std::size_t i = 0; i < 1000; i++) {
+        values.push_back(std::to_string(i));
+    }
+    task::List<std::string, CustomAllocator<std::string>> actual;
+    std::list<std::string> expected;
+    actual.PushBack("front");
+    actual.PushBack("back");
+    expected.push_back("front");
+    expected.push_back("back");
+
+    auto inserted = actual.InsertRange(std::next(actual.Begin()), values.begin(), values.end());
+    expected.insert(std::next(expected.begin()), values.begin(), values.end());
+    ASSERT_EQ(*inserted, "0");
+    ASSERT_EQ(actual.Size(), expected.size());
+    ASSERT_TRUE(std::equal(actual.Begin(), actual.End(), expected.begin(), expected.end()));
+
+    std::istringstream input("1 2 3");
+    task::List<int> numbers;
+    numbers.InsertRange(numbers.End(), std::istream_iterator<int>(input),
+                        std::istream_iterator<int>());
+    ASSERT_EQ(Elements(numbers), (std::vector<int>{1, 2, 3}));
+}
+
+TEST(InsertRange, StrongGuarantee) {
+    struct Throwing {
+        explicit Throwing(int value) : value(value) {
+        }
+        Throwing(const Throwing& other) : value(other.value) {
+            if (value == 100) {
+                throw std::runtime_error("copy");
+            }
+        }
+
+        int value;
+    };
+
+    std::vector<Throwing> values;
+    values.reserve(200);
+    for (int i = 0; i < 200; i++) {
+        values.emplace_back(i);
+    }
+    task::List<Throwing, CustomAllocator<Throwing>> actual;
+    actual.EmplaceBack(-1);
+    ASSERT_THROW(actual.InsertRange(actual.End(), values.begin(), values.end()),
+                 std::runtime_error);
+    ASSERT_EQ(actual.Size(), 1);
+    ASSERT_EQ(actual.Front().value, -1);
+    ASSERT_EQ(actual.Back().value, -1);
+}
+
+TEST(Merge, Stable) {
+    task::List<std::pair<int, char>, CustomAllocator<std::pair<int, char>>> actual;
+    task::List<std::pair<int, char>, CustomAllocator<std::pair<int, char>>> other;
+    for (int i = 0; i < 10; i += 2) {
+        actual.PushBack({i, 'a'});
+        other.PushBack({i, 'b'});
+        other.PushBack({i + 1, 'b'});
+    }
+    actual.Merge(other);
+    ASSERT_TRUE(other.Empty());
+    ASSERT_EQ(actual.Size(), 15);
+    std::vector<std::pair<int, char>> expected;
+    for (int i = 0; i < 10; i += 2) {
+        expected.insert(expected.end(), {{i, 'a'}, {i, 'b'}, {i + 1, 'b'}});
+    }
+    ASSERT_EQ(Elements(actual), expected);
+}
+
+TEST(Merge, CrossAllocator) {
+    using Allocator = TaggedAllocator<int>;
+    {
+        task::List<int, Allocator> actual(Allocator(1));
+        task::List<int, Allocator> other(Allocator(2));
+        for (int i = 0; i < 10; i++) {
+            (i % 3 == 0 ? actual : other).PushBack(i);
+        }
+        actual.Merge(std::move(other));
+        ASSERT_TRUE(other.Empty());
+        ASSERT_EQ(Elements(actual), (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+        ASSERT_EQ(TaggedLiveObjects(1), 10);
+        ASSERT_EQ(TaggedLiveObjects(2), 0);
+    }
+    ASSERT_EQ(TaggedLiveObjects(1), 0);
+}
+
+// Inline nodes
+template <typename T>
+using InlineList = task::List<T, TaggedAllocator<T>, task::InlineNodes<4>>;
+
+TEST(Inline, AllocatesBeyondCapacity) {
+    {
+        InlineList<int> actual(TaggedAllocator<int>(3));
+        for (int i = 0; i < 4; i++) {
+            actual.PushBack(i);
+        }
+        ASSERT_EQ(TaggedLiveObjects(3), 0);
+        actual.PushFront(-1);
+        actual.PushBack(4);
+        ASSERT_EQ(TaggedLiveObjects(3), 2);
+        ASSERT_EQ(Elements(actual), (std::vector<int>{-1, 0, 1, 2, 3, 4}));
+
+        // Freed inline slots are reused before the allocator
+        actual.PopFront();
+        actual.PopFront();
+        actual.PopBack();
+        actual.PushBack(5);
+        actual.PushFront(6);
+        ASSERT_EQ(TaggedLiveObjects(3), 1);
+        ASSERT_EQ(Elements(actual), (std::vector<int>{6, 1, 2, 3, 5}));
+
+        std::vector<int> values = {7, 8, 9};
+        actual.Clear();
+        actual.InsertRange(actual.End(), values.begin(), values.end());
+        ASSERT_EQ(TaggedLiveObjects(3), 0);
+    }
+    ASSERT_EQ(TaggedLiveObjects(3), 0);
+}
+
+TEST(Inline, MoveAndSwap) {
+    using Allocator = TaggedAllocator<std::string>;
+    {
+        InlineList<std::string> first(Allocator(3));
+        InlineList<std::string> second(Allocator(3));
+        for (std::size_t i = 0; i < 6; i++) {
+            first.PushBack(std::string(20, static_cast<char>('a' + i)));
+        }
+        second.PushBack("x");
+        second.PushBack("y");
+        std::vector<std::string> first_values = Elements(first);
+        std::vector<std::string> second_values = Elements(second);
+
+        first.Swap(second);
+        ASSERT_EQ(Elements(first), second_values);
+        ASSERT_EQ(Elements(second), first_values);
+        ASSERT_EQ(*std::prev(second.End()), first_values.back());
+        ASSERT_EQ(TaggedLiveObjects(3), 2);
+
+        InlineList<std::string> moved(std::move(second));
+        ASSERT_TRUE(second.Empty());
+        ASSERT_EQ(Elements(moved), first_values);
+        second.PushBack("z");
+        ASSERT_EQ(Elements(moved), first_values);
+
+        first = std::move(moved);
+        ASSERT_TRUE(moved.Empty());
+        ASSERT_EQ(Elements(first), first_values);
+        for (std::size_t i = 0; i < 6; i++) {
+            moved.PushBack("w");
+        }
+        ASSERT_EQ(Elements(first), first_values);
+        ASSERT_EQ(TaggedLiveObjects(3), 4);
+    }
+    ASSERT_EQ(TaggedLiveObjects(3), 0);
+}
+
+TEST(Inline, SpliceAndMerge) {
+    {
+        InlineList<int> actual(TaggedAllocator<int>(3));
+        InlineList<int> other(TaggedAllocator<int>(3));
+        for (int i = 0; i < 6; i++) {
+            actual.PushBack(2 * i);
+            other.PushBack(2 * i + 1);
+        }
+        actual.Merge(other);
+        ASSERT_TRUE(other.Empty());
+        ASSERT_EQ(Elements(actual), (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}));
+
+        other.PushBack(100);
+        other.PushBack(101);
+        other.PushBack(102);
+        actual.Splice(actual.Begin(), other, std::next(other.Begin()), other.End());
+        actual.Splice(actual.End(), other);
+        ASSERT_TRUE(other.Empty());
+        ASSERT_EQ(actual.Front(), 101);
+        ASSERT_EQ(actual.Back(), 100);
+        ASSERT_EQ(actual.Size(), 15);
+
+        other.PushBack(-1);
+        actual.Sort();
+        ASSERT_EQ(actual.Front(), 0);
+        ASSERT_EQ(other.Front(), -1);
+        ASSERT_EQ(TaggedLiveObjects(3), 11);
+    }
+    ASSERT_EQ(TaggedLiveObjects(3), 0);
+}
+
+// Concurrent list
+TEST(ConcurrentList, Fifo) {
+    task::ConcurrentList<std::string, CustomAllocator<std::string>> queue;
+    std::string value;
+    ASSERT_TRUE(queue.Empty());
+    ASSERT_FALSE(queue.TryPopFront(value));
+    for (std::size_t i = 0; i < 1000; i++) {
+        ASSERT_TRUE(queue.TryPushBack(std::to_string(i)));
+    }
+    for (std::size_t i = 0; i < 500; i++) {
+        ASSERT_TRUE(queue.TryPopFront(value));
+        ASSERT_EQ(value, std::to_string(i));
+    }
+    ASSERT_FALSE(queue.Empty());
+    // The remaining elements are destroyed with the queue
+}
+
+TEST(ConcurrentList, Stress) {
+    constexpr std::size_t kProducers = 4;
+    constexpr std::size_t kConsumers = 4;
+    constexpr std::size_t kCount = 20000;
+    task::ConcurrentList<std::pair<std::size_t, std::size_t>,
+                         CustomAllocator<std::pair<std::size_t, std::size_t>>>
+        queue;
+
+    std::atomic<std::size_t> consumed{0};
+    std::vector<std::vector<std::size_t>> seen(kConsumers * kProducers);
+    std::vector<std::thread> threads;
+    for (std::size_t producer = 0; producer < kProducers; producer++) {
+        threads.emplace_back([&queue, producer] {
+            for (std::size_t i = 0; i < kCount; i++) {
+                while (!queue.TryPushBack({producer, i})) {
+                }
+            }
+        });
+    }
+    for (std::size_t consumer = 0; consumer < kConsumers; consumer++) {
+        threads.emplace_back([&queue, &consumed, &seen, consumer] {
+            std::pair<std::size_t, std::size_t> value;
+            while (consumed.load() < kProducers * kCount) {
+                if (queue.TryPopFront(value)) {
+                    seen[consumer * kProducers + value.first].push_back(value.second);
+                    consumed.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    ASSERT_TRUE(queue.Empty());
+
+    // Every element is popped exactly once and every consumer sees the elements
+    // of one producer in the order they were pushed
+    for (std::size_t producer = 0; producer < kProducers; producer++) {
+        std::vector<std::size_t> all;
+        for (std::size_t consumer = 0; consumer < kConsumers; consumer++) {
+            const std::vector<std::size_t>& part = seen[consumer * kProducers + producer];
+            ASSERT_TRUE(std::is_sorted(part.begin(), part.end()));
+            all.insert(all.end(), part.begin(), part.end());
+        }
+        std::sort(all.begin(), all.end());
+        ASSERT_EQ(all.size(), kCount);
+        for (std::size_t i = 0; i < kCount; i++) {
+            ASSERT_EQ(all[i], i);
+        }
+    }
+}
+
+// Pool
+TEST(Pool, ReusesFreedBlocks) {
+    CustomAllocator<int64_t> alloc;
+    int64_t* first = alloc.allocate(1);
+    alloc.deallocate(first, 1);
+    int64_t* second = alloc.allocate(1);
+    alloc.deallocate(second, 1);
+    ASSERT_EQ(first, second);
+}
+
+TEST(Pool, RebindSharesPool) {
+    CustomAllocator<std::string> alloc;
+    CustomAllocator<std::string>::rebind<char>::other rebound(alloc);
+    ASSERT_TRUE(alloc == rebound);
+
+    std::string* block = alloc.allocate(1);
+    alloc.deallocate(block, 1);
+    char* reused = rebound.allocate(sizeof(std::string));
+    rebound.deallocate(reused, sizeof(std::string));
+    ASSERT_EQ(static_cast<void*>(block), static_cast<void*>(reused));
+}
+
+TEST(Pool, Batch) {
+    CustomAllocator<std::string> alloc;
+    std::string* blocks[100];
+    alloc.allocate_batch(blocks, 100);
+    std::set<std::string*> distinct(std::begin(blocks), std::end(blocks));
+    ASSERT_EQ(distinct.size(), 100);
+    for (std::string* block : blocks) {
+        ASSERT_EQ(reinterpret_cast<std::uintptr_t>(block) % alignof(std::string), 0);
+        alloc.deallocate(block, 1);
+    }
+}
+
+TEST(Pool, Alignment) {
+    CustomAllocator<char> alloc;
+    std::vector<char*> blocks;
+    for (std::size_t size = 1; size <= 2 * pool::kMaxPooledSize; size += 7) {
+        blocks.push_back(alloc.allocate(size));
+        ASSERT_EQ(reinterpret_cast<std::uintptr_t>(blocks.back()) % pool::kAlignment, 0);
+    }
+    std::size_t size = 1;
+    for (char* block : blocks) {
+        alloc.deallocate(block, size);
+        size += 7;
+    }
+}
+
+TEST(ThreadCache, RemoteFreeReturnsToOwner) {
+    constexpr std::size_t kCount = 1000;
+    CustomAllocator<int64_t> alloc;
+    std::vector<int64_t*> blocks;
+    for (std::size_t i = 0; i < kCount; i++) {
+        blocks.push_back(alloc.allocate(1));
+    }
+
+    std::thread foreign([&] {
+        for (int64_t* block : blocks) {
+            alloc.deallocate(block, 1);
+        }
+    });
+    foreign.join();
+
+    std::set<int64_t*> freed(blocks.begin(), blocks.end());
+    std::size_t reused = 0;
+    for (int64_t*& block : blocks) {
+        block = alloc.allocate(1);
+        reused += freed.count(block);
+    }
+    for (int64_t* block : blocks) {
+        alloc.deallocate(block, 1);
+    }
+    ASSERT_GE(reused, kCount - pool::kMagazineSize);
+}
+
+TEST(ThreadCache, ConcurrentLists) {
+    constexpr std::size_t kThreads = 8;
+    constexpr std::size_t kCount = 10000;
+    std::vector<task::List<std::string, CustomAllocator<std::string>>> lists(kThreads);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < kThreads; t++) {
+        threads.emplace_back([&lists, t] {
+            for (std::size_t i = 0; i < kCount; i++) {
+                lists[t].PushBack(std::to_string(i));
+                if (i % 3 == 0) {
+                    lists[t].PopFront();
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+
+    for (std::size_t t = 0; t < kThreads; t++) {
+        ASSERT_EQ(lists[t].Size(), kCount - (kCount + 2) / 3);
+    }
+
+    // Every list is destroyed on a thread other than the one that filled it
+    for (std::size_t t = 0; t < kThreads; t++) {
+        threads.emplace_back([&lists, t] { lists[(t + 1) % kThreads].Clear(); });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+// Stats
+TEST(Stats, LiveAndPeakBytes) {
+    if (!pool::kStatsEnabled) {
+        GTEST_SKIP();
+    }
+    CustomAllocator<int64_t> alloc;
+    pool::StatsSnapshot before = pool::GetStats();
+
+    std::vector<int64_t*> blocks;
+    for (std::size_t i = 0; i < 100; i++) {
+        blocks.push_back(alloc.allocate(1));
+    }
+    pool::StatsSnapshot filled = pool::GetStats();
+    for (int64_t* block : blocks) {
+        alloc.deallocate(block, 1);
+    }
+    pool::StatsSnapshot after = pool::GetStats();
+
+    const std::size_t index = pool::ClassIndex(sizeof(int64_t));
+    ASSERT_EQ(filled.live_bytes - before.live_bytes, 100 * pool::ClassSize(index));
+    ASSERT_GE(filled.peak_bytes, filled.live_bytes);
+    ASSERT_EQ(after.live_bytes, before.live_bytes);
+    ASSERT_EQ(after.classes[index].allocations - before.classes[index].allocations, 100);
+    ASSERT_EQ(after.classes[index].LiveBlocks(), before.classes[index].LiveBlocks());
+}
+
+TEST(Stats, ListNodes) {
+    if (!pool::kStatsEnabled) {
+        GTEST_SKIP();
+    }
+    pool::StatsSnapshot before = pool::GetStats();
+    {
+        task::List<int64_t, CustomAllocator<int64_t>> list;
+        for (int64_t i = 0; i < 1000; i++) {
+            list.PushBack(i);
+        }
+        pool::StatsSnapshot filled = pool::GetStats();
+        ASSERT_EQ(filled.live_bytes - before.live_bytes,
+                  1000 * pool::ClassSize(pool::ClassIndex(sizeof(int64_t) + 2 * sizeof(void*))));
+    }
+    ASSERT_EQ(pool::GetStats().live_bytes, before.live_bytes);
+}
+
+TEST(Stats, LargeAndRemoteFrees) {
+    if (!pool::kStatsEnabled) {
+        GTEST_SKIP();
+    }
+    CustomAllocator<char> alloc;
+    pool::StatsSnapshot before = pool::GetStats();
+
+    char* large = alloc.allocate(4 * pool::kMaxPooledSize);
+    char* small = alloc.allocate(1);
+    std::thread foreign([&] { alloc.deallocate(small, 1); });
+    foreign.join();
+
+    pool::StatsSnapshot after = pool::GetStats();
+    alloc.deallocate(large, 4 * pool::kMaxPooledSize);
+    ASSERT_EQ(after.large_allocations - before.large_allocations, 1);
+    ASSERT_EQ(after.large_live_bytes - before.large_live_bytes, 4 * pool::kMaxPooledSize);
+    ASSERT_EQ(after.remote_frees - before.remote_frees, 1);
+}
+
+TEST(Stats, Json) {
+    if (!pool::kStatsEnabled) {
+        GTEST_SKIP();
+    }
+    task::List<int64_t, CustomAllocator<int64_t>> list;
+    list.PushBack(1);
+    std::string json = pool::DumpStats();
+    ASSERT_EQ(json.front(), '{');
+    ASSERT_EQ(json.back(), '}');
+    ASSERT_NE(json.find("\"enabled\": true"), std::string::npos);
+    ASSERT_NE(json.find("\"peak_bytes\""), std::string::npos);
+    ASSERT_NE(json.find("\"utilization\""), std::string::npos);
+}
+
+// Unrolled storage
+template <typename T>
+using UnrolledList = task::List<T, CustomAllocator<T>, task::UnrolledBlocks<>>;
+
+TEST(Unrolled, PushPopBothEnds) {
+    std::mt19937 random_engine(42);
+    std::uniform_int_distribution<int> distribution(0, 3);
+
+    UnrolledList<std::string> actual;
+    std::list<std::string> expected;
+    for (std::size_t i = 0; i < 10000; i++) {
+        switch (expected.empty() ? distribution(random_engine) % 2 : distribution(random_engine)) {
+            case 0:
+                actual.PushBack(std::to_string(i));
+                expected.push_back(std::to_string(i));
+                break;
+            case 1:
+                actual.PushFront(std::to_string(i));
+                expected.push_front(std::to_string(i));
+                break;
+            case 2:
+                actual.PopBack();
+                expected.pop_back();
+                break;
+            default:
+                actual.PopFront();
+                expected.pop_front();
+                break;
+        }
+    }
+    ASSERT_EQ(actual.Size(), expected.size());
+    ASSERT_TRUE(std::equal(actual.Begin(), actual.End(), expected.begin(), expected.end()));
+    ASSERT_TRUE(std::equal(std::make_reverse_iterator(actual.End()),
+                           std::make_reverse_iterator(actual.Begin()), expected.rbegin(),
+                           expected.rend()));
+}
+
+TEST(Unrolled, Remove) {
+    UnrolledList<std::string> actual;
+    std::list<std::string> expected;
+    for (std::size_t i = 0; i < 1000; i++) {
+        actual.PushBack(std::to_string(i % 7));
+        expected.push_back(std::to_string(i % 7));
+    }
+    // The argument aliases an element which is removed itself
+    actual.Remove(*std::next(actual.Begin(), 3));
+    expected.remove("3");
+    ASSERT_EQ(actual.Size(), expected.size());
+    ASSERT_TRUE(std::equal(actual.Begin(), actual.End(), expected.begin(), expected.end()));
+}
+
+TEST(Unrolled, Unique) {
+    UnrolledList<int> actual;
+    std::list<int> expected;
+    for (int i = 0; i < 1000; i++) {
+        actual.PushFront(i / 5);
+        expected.push_front(i / 5);
+    }
+    actual.Unique();
+    expected.unique();
+    ASSERT_EQ(actual.Size(), expected.size());
+    ASSERT_TRUE(std::equal(actual.Begin(), actual.End(), expected.begin(), expected.end()));
+}
+
+TEST(Unrolled, Sort) {
+    std::mt19937 random_engine(42);
+    std::uniform_int_distribution<int> distribution(1, 100);
+
+    UnrolledList<int> actual;
+    std::list<int> expected;
+    for (std::size_t i = 0; i < 1000; ++i) {
+        int value = distribution(random_engine);
+        actual.PushBack(value);
+        expected.push_back(value);
+    }
+    actual.Sort();
+    expected.sort();
+    ASSERT_TRUE(std::equal(actual.Begin(), actual.End(), expected.begin(), expected.end()));
+}
+
+// Fails the comparison after a given number of calls
+struct FragileString {
+    static int comparisons_left;
+
+    bool operator<(const FragileString& other) const {
+        if (--comparisons_left == 0) {
+            throw std::runtime_error("comparison failed");
+        }
+        return value < other.value;
+    }
+
+    std::string value;
+};
+
+int FragileString::comparisons_left = 0;
+
+TEST(Unrolled, SortThrowingComparison) {
+    UnrolledList<FragileString> actual;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 300; i++) {
+        expected.push_back("value " + std::to_string((i * 37) % 300));
+        actual.PushBack({expected.back()});
+    }
+    for (int fail_at : {1, 50, 1000, 2000}) {
+        FragileString::comparisons_left = fail_at;
+        ASSERT_THROW(actual.Sort(), std::runtime_error);
+        std::vector<std::string> values;
+        for (auto it = actual.Begin(); it != actual.End(); ++it) {
+            values.push_back(it->value);
+        }
+        ASSERT_EQ(values, expected);
+    }
+
+    FragileString::comparisons_left = 0;
+    actual.Sort();
+    std::sort(expected.begin(), expected.end());
+    std::vector<std::string> values;
+    for (auto it = actual.Begin(); it != actual.End(); ++it) {
+        values.push_back(it->value);
+    }
+    ASSERT_EQ(values, expected);
+}
+
+TEST(Unrolled, MergeThrowingComparison) {
+    for (int fail_at : {1, 20, 150}) {
+        UnrolledList<FragileString> actual;
+        UnrolledList<FragileString> other;
+        std::vector<std::string> expected;
+        for (int i = 0; i < 100; i++) {
+            actual.PushBack({"value " + std::to_string(100 + 2 * i)});
+            other.PushBack({"value " + std::to_string(101 + 2 * i)});
+        }
+        for (const auto* list : {&actual, &other}) {
+            for (auto it = list->Begin(); it != list->End(); ++it) {
+                expected.push_back(it->value);
+            }
+        }
+
+        // Nothing is lost: the elements of other stay appended
+        FragileString::comparisons_left = fail_at;
+        ASSERT_THROW(actual.Merge(other), std::runtime_error);
+        ASSERT_TRUE(other.Empty());
+        std::vector<std::string> values;
+        for (auto it = actual.Begin(); it != actual.End(); ++it) {
+            values.push_back(it->value);
+        }
+        ASSERT_EQ(values, expected);
+    }
+}
+
+TEST(Unrolled, CopyMoveSwap) {
+    UnrolledList<std::string> first;
+    for (std::size_t i = 0; i < 100; i++) {
+        first.PushBack(std::to_string(i));
+    }
+    UnrolledList<std::string> copy = first;
+    ASSERT_TRUE(std::equal(first.Begin(), first.End(), copy.Begin(), copy.End()));
+
+    UnrolledList<std::string> moved = std::move(copy);
+    ASSERT_TRUE(copy.Empty());
+    ASSERT_TRUE(std::equal(first.Begin(), first.End(), moved.Begin(), moved.End()));
+
+    UnrolledList<std::string> second;
+    second.PushBack("world");
+    second.Swap(moved);
+    ASSERT_EQ(moved.Size(), 1);
+    ASSERT_EQ(moved.Front(), "world");
+    ASSERT_TRUE(std::equal(first.Begin(), first.End(), second.Begin(), second.End()));
+
+    second.Resize(10);
+    ASSERT_EQ(second.Size(), 10);
+    ASSERT_EQ(second.Back(), "9");
+    second.Clear();
+    ASSERT_TRUE(second.Begin() == second.End());
+}
+
+TEST(Unrolled, SpliceAndInsert) {
+    std::mt19937 random_engine(42);
+    UnrolledList<int> actual;
+    UnrolledList<int> other;
+    std::list<int> expected;
+    std::list<int> expected_other;
+    for (int i = 0; i < 500; i++) {
+        actual.PushBack(i);
+        expected.push_back(i);
+        other.PushBack(1000 + i);
+        expected_other.push_back(1000 + i);
+    }
+
+    // Positions fall inside blocks, so the splits are exercised
+    auto random_offset = [&random_engine](std::size_t size) {
+        return std::uniform_int_distribution<std::size_t>(0, size)(random_engine);
+    };
+    for (int round = 0; round < 50; round++) {
+        std::size_t pos = random_offset(actual.Size());
+        std::size_t first = random_offset(other.Size());
+        std::size_t last = first + random_offset(other.Size() - first) / 4;
+        actual.Splice(std::next(actual.Begin(), pos), other, std::next(other.Begin(), first),
+                      std::next(other.Begin(), last));
+        expected.splice(std::next(expected.begin(), pos), expected_other,
+                        std::next(expected_other.begin(), first),
+                        std::next(expected_other.begin(), last));
+
+        // Within one list: move a range behind pos
+        first = random_offset(actual.Size() - 1);
+        last = first + 1 + random_offset(actual.Size() - first - 1) / 2;
+        pos = last + random_offset(actual.Size() - last);
+        actual.Splice(std::next(actual.Begin(), pos), actual, std::next(actual.Begin(), first),
+                      std::next(actual.Begin(), last));
+        expected.splice(std::next(expected.begin(), pos), expected,
+                        std::next(expected.begin(), first), std::next(expected.begin(), last));
+
+        std::vector<int> values(3, round);
+        pos = random_offset(actual.Size());
+        auto inserted = actual.InsertRange(std::next(actual.Begin(), pos), values.begin(),
+                                           values.end());
+        ASSERT_EQ(inserted, std::next(actual.Begin(), pos));
+        expected.insert(std::next(expected.begin(), pos), values.begin(), values.end());
+    }
+    ASSERT_EQ(actual.Size(), expected.size());
+    ASSERT_EQ(other.Size(), expected_other.size());
+    ASSERT_TRUE(std::equal(actual.Begin(), actual.End(), expected.begin(), expected.end()));
+    ASSERT_TRUE(std::equal(other.Begin(), other.End(), expected_other.begin(),
+                           expected_other.end()));
+    ASSERT_TRUE(std::equal(std::make_reverse_iterator(actual.End()),
+                           std::make_reverse_iterator(actual.Begin()), expected.rbegin(),
+                           expected.rend()));
+
+    actual.Splice(std::next(actual.Begin(), 7), other);
+    expected.splice(std::next(expected.begin(), 7), expected_other);
+    ASSERT_TRUE(other.Empty());
+    ASSERT_TRUE(std::equal(actual.Begin(), actual.End(), expected.begin(), expected.end()));
+}
+
+TEST(Unrolled, CrossAllocator) {
+    using Allocator = TaggedAllocator<std::string>;
+    using List = task::List<std::string, Allocator, task::UnrolledBlocks<>>;
+    {
+        List actual(Allocator(1));
+        List other(Allocator(2));
+        for (std::size_t i = 0; i < 10; i++) {
+            actual.PushBack(std::to_string(i));
+            other.PushBack(std::to_string(10 + i));
+        }
+
+        actual.Splice(std::next(actual.Begin(), 5), other, std::next(other.Begin()),
+                      std::next(other.Begin(), 3));
+        ASSERT_EQ(actual.Size(), 12);
+        ASSERT_EQ(other.Size(), 8);
+        ASSERT_EQ(*std::next(actual.Begin(), 5), "11");
+        ASSERT_EQ(*std::next(other.Begin()), "13");
+
+        actual.Sort();
+        other.Sort();
+        actual.Merge(other);
+        ASSERT_TRUE(other.Empty());
+        ASSERT_EQ(actual.Size(), 20);
+        ASSERT_TRUE(std::is_sorted(actual.Begin(), actual.End()));
+    }
+    ASSERT_EQ(TaggedLiveObjects(1), 0);
+    ASSERT_EQ(TaggedLiveObjects(2), 0);
+}
+
+TEST(Unrolled, Merge) {
+    UnrolledList<std::pair<int, char>> actual;
+    UnrolledList<std::pair<int, char>> other;
+    for (int i = 0; i < 100; i += 2) {
+        actual.PushBack({i, 'a'});
+        other.PushBack({i, 'b'});
+        other.PushBack({i + 1, 'b'});
+    }
+    actual.Merge(other);
+    ASSERT_TRUE(other.Empty());
+    ASSERT_EQ(actual.Size(), 150);
+    std::vector<std::pair<int, char>> expected;
+    for (int i = 0; i < 100; i += 2) {
+        expected.insert(expected.end(), {{i, 'a'}, {i, 'b'}, {i + 1, 'b'}});
+    }
+    ASSERT_EQ(Elements(actual), expected);
+}
+
+TEST(Unrolled, ParallelSort) {
+    std::mt19937 random_engine(42);
+    std::uniform_int_distribution<int> distribution;
+
+    UnrolledList<int> actual;
+    std::list<int> expected;
+    for (std::size_t i = 0; i < 100000; i++) {
+        int value = distribution(random_engine);
+        actual.PushBack(value);
+        expected.push_back(value);
+    }
+    actual.ParallelSort(3);
+    expected.sort();
+    ASSERT_EQ(actual.Size(), expected.size());
+    ASSERT_TRUE(std::equal(actual.Begin(), actual.End(), expected.begin(), expected.end()));
+}
+
+template <typename Allocator>
+task::List<std::string, Allocator> PushBackWorkload(std::size_t count) {
+    task::List<std::string, Allocator> list;
+    for (std::size_t i = 0; i < count; i++) {
+        list.PushBack(std::to_string(i));
+    }
+    return list;
+}
+
+template <typename Allocator>
+task::List<std::string, Allocator> PopFrontWorkload(std::size_t count) {
+    task::List<std::string, Allocator> list = PushBackWorkload<Allocator>(count);
+    for (std::size_t i = 0; i < count / 2; i++) {
+        list.PopFront();
+    }
+    return list;
+}
+
+template <typename Allocator>
+task::List<std::string, Allocator> MixedWorkload(std::size_t rounds) {
+    task::List<std::string, Allocator> list;
+    for (std::size_t round = 0; round < rounds; round++) {
+        for (std::size_t i = 0; i < 5; i++) {
+            list.PushBack(std::to_string(round));
+        }
+        for (std::size_t i = 0; i < 3; i++) {
+            list.PopFront();
+        }
+        for (std::size_t i = 0; i < 5; i++) {
+            list.PushFront(std::to_string(i));
+        }
+        for (std::size_t i = 0; i < 3; i++) {
+            list.PopBack();
+        }
+    }
+    return list;
+}
+
+TEST(PoolWorkload, PushBack) {
+    auto actual = PushBackWorkload<CustomAllocator<std::string>>(100000);
+    auto expected = PushBackWorkload<std::allocator<std::string>>(100000);
+    ASSERT_TRUE(std::equal(actual.Begin(), actual.End(), expected.Begin(), expected.End()));
+}
+
+TEST(PoolWorkload, PopFront) {
+    auto actual = PopFrontWorkload<CustomAllocator<std::string>>(100000);
+    auto expected = PopFrontWorkload<std::allocator<std::string>>(100000);
+    ASSERT_TRUE(std::equal(actual.Begin(), actual.End(), expected.Begin(), expected.End()));
+}
+
+TEST(PoolWorkload, Mixed) {
+    auto actual = MixedWorkload<CustomAllocator<std::string>>(10000);
+    auto expected = MixedWorkload<std::allocator<std::string>>(10000);
+    ASSERT_TRUE(std::equal(actual.Begin(), actual.End(), expected.Begin(), expected.End()));
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,89 @@
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "../biginteger.h"
+#include "benchmark/benchmark.h"
+
+// Random number of range(0) decimal digits
+BigInteger RandomBigInteger(benchmark::State& state, unsigned seed) {
+    std::mt19937 random_engine(seed);
+    std::uniform_int_distribution<int> digit(0, 9);
+    std::string digits(1, static_cast<char>('1' + digit(random_engine) % 9));
+    for (int64_t i = 1; i < state.range(0); i++) {
+        digits += static_cast<char>('0' + digit(random_engine));
+    }
+    std::istringstream iss(digits);
+    BigInteger result;
+    iss >> result;
+    return result;
+}
+
+void Add(benchmark::State& state) {
+    BigInteger a = RandomBigInteger(state, 1);
+    BigInteger b = RandomBigInteger(state, 2);
+    for (auto _ : state) {
+        BigInteger sum = a + b;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+// Items are the digits of one operand, the sizes step by 2 across the
+// schoolbook, Karatsuba and Toom-3 thresholds
+void Multiply(benchmark::State& state) {
+    BigInteger a = RandomBigInteger(state, 1);
+    BigInteger b = RandomBigInteger(state, 2);
+    for (auto _ : state) {
+        BigInteger product = a * b;
+        benchmark::DoNotOptimize(product);
+    }
+    state.SetComplexityN(state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// The number-theoretic transform sizes, up to operands of 16M digits
+void MultiplyHuge(benchmark::State& state) {
+    Multiply(state);
+}
+
+void Divide(benchmark::State& state) {
+    BigInteger a = RandomBigInteger(state, 1);
+    a *= a;
+    BigInteger b = RandomBigInteger(state, 2);
+    for (auto _ : state) {
+        BigInteger quotient = a / b;
+        benchmark::DoNotOptimize(quotient);
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+void ToString(benchmark::State& state) {
+    BigInteger a = RandomBigInteger(state, 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a.toString());
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+void Increment(benchmark::State& state) {
+    BigInteger a = RandomBigInteger(state, 1);
+    for (auto _ : state) {
+        ++a;
+        benchmark::DoNotOptimize(a);
+    }
+}
+
+BENCHMARK(Add)->Range(1 << 4, 1 << 16)->Complexity();
+BENCHMARK(Multiply)->RangeMultiplier(2)->Range(1 << 4, 1 << 16)->Complexity();
+BENCHMARK(MultiplyHuge)
+    ->RangeMultiplier(4)
+    ->Range(1 << 16, 1 << 24)
+    ->Unit(benchmark::kMillisecond)
+    ->Complexity(benchmark::oNLogN);
+BENCHMARK(Divide)->Range(1 << 4, 1 << 12)->Complexity();
+BENCHMARK(ToString)->Range(1 << 4, 1 << 16)->Complexity();
+BENCHMARK(Increment)->Range(1 << 4, 1 << 16);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,796 @@
+#include "biginteger.h"
+
+namespace {
+
+using Limb = uint32_t;
+using Wide = uint64_t;
+using Limbs = std::vector<Limb>;
+
+constexpr int kLimbBits = 32;
+constexpr Limb kDecimalBase = 1000000000;
+constexpr std::size_t kDecimalDigits = 9;
+
+// Operands shorter than kKaratsubaThreshold limbs are multiplied by the
+// schoolbook method, shorter than kToom3Threshold by Karatsuba, shorter than
+// kNttThreshold by Toom-3 and longer by the number-theoretic transform.
+// Tuned with the Multiply benchmarks
+constexpr std::size_t kKaratsubaThreshold = 40;
+constexpr std::size_t kToom3Threshold = 250;
+constexpr std::size_t kNttThreshold = 3000;
+
+// The transform is computed modulo three primes c * 2^k + 1, with 3 as a
+// primitive root, and the coefficients are restored by the Chinese remainder
+// theorem. A coefficient of a product of n limbs by m limbs is less than
+// min(n, m) * 2^64, which is less than the product of the primes for
+// n + m <= 2^23, the longest transform modulo kPrime1
+constexpr Limb kPrime1 = 998244353;  // 119 * 2^23 + 1
+constexpr Limb kPrime2 = 167772161;  // 5 * 2^25 + 1
+constexpr Limb kPrime3 = 469762049;  // 7 * 2^26 + 1
+constexpr Limb kPrimitiveRoot = 3;
+constexpr std::size_t kNttMaxLength = std::size_t{1} << 23;
+
+// Up to this many decimal chunks are converted to limbs one by one
+constexpr std::size_t kDecimalSplitThreshold = 64;
+
+// Limbs of a magnitude without its own storage, least significant first
+struct View {
+    const Limb* data;
+    std::size_t size;
+};
+
+View Of(const Limbs& limbs) {
+    return {limbs.data(), limbs.size()};
+}
+
+void Trim(Limbs& limbs) {
+    while (!limbs.empty() && limbs.back() == 0) {
+        limbs.pop_back();
+    }
+}
+
+// Limbs [from, from + count) of a, clipped to its size, without leading zeros
+View Slice(View a, std::size_t from, std::size_t count) {
+    if (from >= a.size) {
+        return {a.data, 0};
+    }
+    View slice{a.data + from, a.size - from < count ? a.size - from : count};
+    while (slice.size > 0 && slice.data[slice.size - 1] == 0) {
+        --slice.size;
+    }
+    return slice;
+}
+
+int Compare(View a, View b) {
+    if (a.size != b.size) {
+        return a.size < b.size ? -1 : 1;
+    }
+    for (std::size_t i = a.size; i-- > 0;) {
+        if (a.data[i] != b.data[i]) {
+            return a.data[i] < b.data[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+Limbs Add(View a, View b) {
+    if (a.size < b.size) {
+        return Add(b, a);
+    }
+    Limbs sum(a.size + 1);
+    Wide carry = 0;
+    for (std::size_t i = 0; i < a.size; ++i) {
+        carry += static_cast<Wide>(a.data[i]) + (i < b.size ? b.data[i] : 0);
+        sum[i] = static_cast<Limb>(carry);
+        carry >>= kLimbBits;
+    }
+    sum[a.size] = static_cast<Limb>(carry);
+    Trim(sum);
+    return sum;
+}
+
+// a - b for a >= b
+Limbs Subtract(View a, View b) {
+    Limbs difference(a.size);
+    Wide borrow = 0;
+    for (std::size_t i = 0; i < a.size; ++i) {
+        Wide d = static_cast<Wide>(a.data[i]) - (i < b.size ? b.data[i] : 0) - borrow;
+        difference[i] = static_cast<Limb>(d);
+        borrow = d >> (2 * kLimbBits - 1);
+    }
+    Trim(difference);
+    return difference;
+}
+
+// Adds a to the limbs of r from offset, r has room for the carry
+void AddAt(Limbs& r, View a, std::size_t offset) {
+    Wide carry = 0;
+    for (std::size_t i = 0; i < a.size; ++i) {
+        carry += static_cast<Wide>(r[offset + i]) + a.data[i];
+        r[offset + i] = static_cast<Limb>(carry);
+        carry >>= kLimbBits;
+    }
+    for (std::size_t i = offset + a.size; carry != 0; ++i) {
+        carry += r[i];
+        r[i] = static_cast<Limb>(carry);
+        carry >>= kLimbBits;
+    }
+}
+
+// Subtracts a from r, which stays non-negative
+void SubtractAt(Limbs& r, View a) {
+    Wide borrow = 0;
+    for (std::size_t i = 0; i < a.size; ++i) {
+        Wide d = static_cast<Wide>(r[i]) - a.data[i] - borrow;
+        r[i] = static_cast<Limb>(d);
+        borrow = d >> (2 * kLimbBits - 1);
+    }
+    for (std::size_t i = a.size; borrow != 0; ++i) {
+        borrow = r[i] == 0 ? 1 : 0;
+        --r[i];
+    }
+    Trim(r);
+}
+
+// a = a * factor + addend
+void MultiplyAddSmall(Limbs& a, Limb factor, Limb addend) {
+    Wide carry = addend;
+    for (Limb& limb : a) {
+        carry += static_cast<Wide>(limb) * factor;
+        limb = static_cast<Limb>(carry);
+        carry >>= kLimbBits;
+    }
+    if (carry != 0) {
+        a.push_back(static_cast<Limb>(carry));
+    }
+}
+
+// a = a / divisor, returns the remainder
+Limb DivideSmall(Limbs& a, Limb divisor) {
+    Wide remainder = 0;
+    for (std::size_t i = a.size(); i-- > 0;) {
+        Wide current = (remainder << kLimbBits) | a[i];
+        a[i] = static_cast<Limb>(current / divisor);
+        remainder = current % divisor;
+    }
+    Trim(a);
+    return static_cast<Limb>(remainder);
+}
+
+void HalveExact(Limbs& a) {
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        a[i] = (a[i] >> 1) | (i + 1 < a.size() ? a[i + 1] << (kLimbBits - 1) : 0);
+    }
+    Trim(a);
+}
+
+Limbs Multiply(View a, View b);
+
+Limbs MultiplySchoolbook(View a, View b) {
+    Limbs product(a.size + b.size);
+    for (std::size_t i = 0; i < a.size; ++i) {
+        Wide carry = 0;
+        Wide factor = a.data[i];
+        for (std::size_t j = 0; j < b.size; ++j) {
+            carry += factor * b.data[j] + product[i + j];
+            product[i + j] = static_cast<Limb>(carry);
+            carry >>= kLimbBits;
+        }
+        product[i + b.size] = static_cast<Limb>(carry);
+    }
+    Trim(product);
+    return product;
+}
+
+// a is at least twice as long as b: the products of b and slices of a of
+// its length are balanced
+Limbs MultiplyUnbalanced(View a, View b) {
+    Limbs product(a.size + b.size + 1);
+    for (std::size_t offset = 0; offset < a.size; offset += b.size) {
+        AddAt(product, Of(Multiply(Slice(a, offset, b.size), b)), offset);
+    }
+    Trim(product);
+    return product;
+}
+
+// a1 * x + a0 times b1 * x + b0 with three products instead of four
+Limbs MultiplyKaratsuba(View a, View b) {
+    std::size_t k = (a.size + 1) / 2;
+    View a0 = Slice(a, 0, k);
+    View a1 = Slice(a, k, a.size);
+    View b0 = Slice(b, 0, k);
+    View b1 = Slice(b, k, b.size);
+
+    Limbs z0 = Multiply(a0, b0);
+    Limbs z2 = Multiply(a1, b1);
+    Limbs z1 = Multiply(Of(Add(a0, a1)), Of(Add(b0, b1)));
+    SubtractAt(z1, Of(z0));
+    SubtractAt(z1, Of(z2));
+
+    Limbs product(a.size + b.size + 1);
+    AddAt(product, Of(z0), 0);
+    AddAt(product, Of(z1), k);
+    AddAt(product, Of(z2), 2 * k);
+    Trim(product);
+    return product;
+}
+
+// Intermediate values of Toom-3 may be negative
+struct Signed {
+    Limbs magnitude;
+    bool negative = false;
+};
+
+Signed AddSigned(const Signed& a, const Signed& b, bool subtract = false) {
+    bool b_negative = b.negative != subtract;
+    if (a.negative == b_negative) {
+        return {Add(Of(a.magnitude), Of(b.magnitude)), a.negative};
+    }
+    int order = Compare(Of(a.magnitude), Of(b.magnitude));
+    if (order >= 0) {
+        return {Subtract(Of(a.magnitude), Of(b.magnitude)), order != 0 && a.negative};
+    }
+    return {Subtract(Of(b.magnitude), Of(a.magnitude)), b_negative};
+}
+
+Signed MultiplySigned(const Signed& a, const Signed& b) {
+    Signed product{Multiply(Of(a.magnitude), Of(b.magnitude)), a.negative != b.negative};
+    product.negative = product.negative && !product.magnitude.empty();
+    return product;
+}
+
+Signed ToSigned(View a) {
+    return {Limbs(a.data, a.data + a.size), false};
+}
+
+// Three parts in each operand, five products at the points 0, 1, -1, -2 and
+// infinity and Bodrato's interpolation sequence
+Limbs MultiplyToom3(View a, View b) {
+    std::size_t k = (a.size + 2) / 3;
+    if (b.size <= 2 * k) {
+        return MultiplyKaratsuba(a, b);
+    }
+    Signed a0 = ToSigned(Slice(a, 0, k));
+    Signed a1 = ToSigned(Slice(a, k, k));
+    Signed a2 = ToSigned(Slice(a, 2 * k, a.size));
+    Signed b0 = ToSigned(Slice(b, 0, k));
+    Signed b1 = ToSigned(Slice(b, k, k));
+    Signed b2 = ToSigned(Slice(b, 2 * k, b.size));
+
+    Signed a02 = AddSigned(a0, a2);
+    Signed a_minus_1 = AddSigned(a02, a1, true);
+    Signed a_1 = AddSigned(a02, a1);
+    Signed a_minus_2 = AddSigned(a_minus_1, a2);
+    a_minus_2 = AddSigned(AddSigned(a_minus_2, a_minus_2), a0, true);
+
+    Signed b02 = AddSigned(b0, b2);
+    Signed b_minus_1 = AddSigned(b02, b1, true);
+    Signed b_1 = AddSigned(b02, b1);
+    Signed b_minus_2 = AddSigned(b_minus_1, b2);
+    b_minus_2 = AddSigned(AddSigned(b_minus_2, b_minus_2), b0, true);
+
+    Signed r0 = MultiplySigned(a0, b0);
+    Signed r1 = MultiplySigned(a_1, b_1);
+    Signed r_minus_1 = MultiplySigned(a_minus_1, b_minus_1);
+    Signed r_minus_2 = MultiplySigned(a_minus_2, b_minus_2);
+    Signed r4 = MultiplySigned(a2, b2);
+
+    Signed r3 = AddSigned(r_minus_2, r1, true);
+    DivideSmall(r3.magnitude, 3);
+    r1 = AddSigned(r1, r_minus_1, true);
+    HalveExact(r1.magnitude);
+    Signed r2 = AddSigned(r_minus_1, r0, true);
+    r3 = AddSigned(r2, r3, true);
+    HalveExact(r3.magnitude);
+    r3 = AddSigned(r3, AddSigned(r4, r4));
+    r2 = AddSigned(AddSigned(r2, r1), r4, true);
+    r1 = AddSigned(r1, r3, true);
+
+    // The coefficients of the product are non-negative
+    Limbs product(a.size + b.size + 1);
+    AddAt(product, Of(r0.magnitude), 0);
+    AddAt(product, Of(r1.magnitude), k);
+    AddAt(product, Of(r2.magnitude), 2 * k);
+    AddAt(product, Of(r3.magnitude), 3 * k);
+    AddAt(product, Of(r4.magnitude), 4 * k);
+    Trim(product);
+    return product;
+}
+
+template <Limb kModulus>
+constexpr Limb PowerModulo(Limb base, Wide exponent) {
+    Wide result = 1;
+    Wide power = base;
+    for (; exponent != 0; exponent >>= 1) {
+        if ((exponent & 1) != 0) {
+            result = result * power % kModulus;
+        }
+        power = power * power % kModulus;
+    }
+    return static_cast<Limb>(result);
+}
+
+template <Limb kModulus>
+Limb MultiplyModulo(Limb a, Limb b) {
+    return static_cast<Limb>(static_cast<Wide>(a) * b % kModulus);
+}
+
+template <Limb kModulus>
+Limb AddModulo(Limb a, Limb b) {
+    Limb sum = a + b;
+    return sum >= kModulus ? sum - kModulus : sum;
+}
+
+// roots[half + j] is w^j for the root w of order 2 * half, for every power
+// of two half less than length
+template <Limb kModulus>
+std::vector<Limb> NttRoots(std::size_t length, bool inverse) {
+    std::vector<Limb> roots(length);
+    for (std::size_t half = 1; half < length; half *= 2) {
+        Limb root = PowerModulo<kModulus>(kPrimitiveRoot, (kModulus - 1) / (2 * half));
+        if (inverse) {
+            root = PowerModulo<kModulus>(root, kModulus - 2);
+        }
+        roots[half] = 1;
+        for (std::size_t j = 1; j < half; ++j) {
+            roots[half + j] = MultiplyModulo<kModulus>(roots[half + j - 1], root);
+        }
+    }
+    return roots;
+}
+
+// Decimation in frequency: the result is in bit-reversed order, which the
+// pointwise product does not care about and the inverse transform takes
+template <Limb kModulus>
+void NttForward(std::vector<Limb>& data, const std::vector<Limb>& roots) {
+    std::size_t length = data.size();
+    for (std::size_t half = length / 2; half > 0; half /= 2) {
+        const Limb* w = &roots[half];
+        for (std::size_t block = 0; block < length; block += 2 * half) {
+            Limb* low = &data[block];
+            Limb* high = low + half;
+            for (std::size_t j = 0; j < half; ++j) {
+                Limb u = low[j];
+                Limb v = high[j];
+                low[j] = AddModulo<kModulus>(u, v);
+                high[j] = MultiplyModulo<kModulus>(u + kModulus - v, w[j]);
+            }
+        }
+    }
+}
+
+// Decimation in time from the bit-reversed order, with inverse roots
+template <Limb kModulus>
+void NttInverse(std::vector<Limb>& data, const std::vector<Limb>& roots) {
+    std::size_t length = data.size();
+    for (std::size_t half = 1; half < length; half *= 2) {
+        const Limb* w = &roots[half];
+        for (std::size_t block = 0; block < length; block += 2 * half) {
+            Limb* low = &data[block];
+            Limb* high = low + half;
+            for (std::size_t j = 0; j < half; ++j) {
+                Limb u = low[j];
+                Limb v = MultiplyModulo<kModulus>(high[j], w[j]);
+                low[j] = AddModulo<kModulus>(u, v);
+                high[j] = AddModulo<kModulus>(u, kModulus - v);
+            }
+        }
+    }
+    Limb scale = PowerModulo<kModulus>(static_cast<Limb>(length % kModulus), kModulus - 2);
+    for (Limb& value : data) {
+        value = MultiplyModulo<kModulus>(value, scale);
+    }
+}
+
+// The coefficients of the product of a and b modulo kModulus
+template <Limb kModulus>
+std::vector<Limb> ConvolveModulo(View a, View b, std::size_t length) {
+    std::vector<Limb> roots = NttRoots<kModulus>(length, false);
+    std::vector<Limb> fa(length);
+    for (std::size_t i = 0; i < a.size; ++i) {
+        fa[i] = a.data[i] % kModulus;
+    }
+    NttForward<kModulus>(fa, roots);
+    if (a.data == b.data && a.size == b.size) {
+        for (Limb& value : fa) {
+            value = MultiplyModulo<kModulus>(value, value);
+        }
+    } else {
+        std::vector<Limb> fb(length);
+        for (std::size_t i = 0; i < b.size; ++i) {
+            fb[i] = b.data[i] % kModulus;
+        }
+        NttForward<kModulus>(fb, roots);
+        for (std::size_t i = 0; i < length; ++i) {
+            fa[i] = MultiplyModulo<kModulus>(fa[i], fb[i]);
+        }
+    }
+    NttInverse<kModulus>(fa, NttRoots<kModulus>(length, true));
+    return fa;
+}
+
+// Exact in integers: Garner's form x1 + p1 * (t2 + p2 * t3) of every
+// coefficient is added to the product with the carry of the lower ones
+Limbs MultiplyNtt(View a, View b) {
+    constexpr Limb kInverse1 = PowerModulo<kPrime2>(kPrime1 % kPrime2, kPrime2 - 2);
+    constexpr Limb kInverse12 = PowerModulo<kPrime3>(
+        static_cast<Limb>(static_cast<Wide>(kPrime1) * kPrime2 % kPrime3), kPrime3 - 2);
+    constexpr Wide kLowMask = (Wide{1} << kLimbBits) - 1;
+
+    std::size_t coefficients = a.size + b.size - 1;
+    std::size_t length = 1;
+    while (length < coefficients) {
+        length *= 2;
+    }
+    std::vector<Limb> r1 = ConvolveModulo<kPrime1>(a, b, length);
+    std::vector<Limb> r2 = ConvolveModulo<kPrime2>(a, b, length);
+    std::vector<Limb> r3 = ConvolveModulo<kPrime3>(a, b, length);
+
+    Limbs product(a.size + b.size);
+    Wide carry = 0;
+    for (std::size_t i = 0; i < coefficients; ++i) {
+        Wide x1 = r1[i];
+        Wide t2 = (r2[i] + kPrime2 - x1 % kPrime2) * kInverse1 % kPrime2;
+        Wide x12 = (x1 + kPrime1 * t2) % kPrime3;
+        Wide t3 = (r3[i] + kPrime3 - x12) * kInverse12 % kPrime3;
+        Wide v = t3 * kPrime2 + t2;
+        Wide low = (v & kLowMask) * kPrime1 + x1 + (carry & kLowMask);
+        Wide high = (v >> kLimbBits) * kPrime1 + (low >> kLimbBits) + (carry >> kLimbBits);
+        product[i] = static_cast<Limb>(low);
+        carry = high;
+    }
+    product[coefficients] = static_cast<Limb>(carry);
+    Trim(product);
+    return product;
+}
+
+Limbs Multiply(View a, View b) {
+    if (a.size < b.size) {
+        return Multiply(b, a);
+    }
+    if (b.size < kKaratsubaThreshold) {
+        return MultiplySchoolbook(a, b);
+    }
+    if (a.size >= 2 * b.size) {
+        return MultiplyUnbalanced(a, b);
+    }
+    if (b.size >= kNttThreshold && a.size + b.size <= kNttMaxLength) {
+        return MultiplyNtt(a, b);
+    }
+    if (b.size < kToom3Threshold) {
+        return MultiplyKaratsuba(a, b);
+    }
+    return MultiplyToom3(a, b);
+}
+
+// count decimal chunks of nine digits, least significant first. powers[k]
+// is 10^(9 * 2^k): the halves are joined with one fast multiplication
+Limbs FromDecimal(const Limb* chunks, std::size_t count, std::vector<Limbs>& powers) {
+    if (count <= kDecimalSplitThreshold) {
+        Limbs result;
+        for (std::size_t i = count; i-- > 0;) {
+            MultiplyAddSmall(result, kDecimalBase, chunks[i]);
+        }
+        return result;
+    }
+    std::size_t level = 0;
+    while ((std::size_t{2} << level) < count) {
+        ++level;
+    }
+    while (powers.size() <= level) {
+        powers.push_back(Multiply(Of(powers.back()), Of(powers.back())));
+    }
+    std::size_t half = std::size_t{1} << level;
+    Limbs low = FromDecimal(chunks, half, powers);
+    Limbs high = FromDecimal(chunks + half, count - half, powers);
+    return Add(Of(Multiply(Of(high), Of(powers[level]))), Of(low));
+}
+
+Limbs ShiftLeft(View a, int bits, std::size_t size) {
+    Limbs shifted(size);
+    for (std::size_t i = 0; i < a.size; ++i) {
+        shifted[i] |= a.data[i] << bits;
+        if (bits != 0 && i + 1 < size) {
+            shifted[i + 1] = a.data[i] >> (kLimbBits - bits);
+        }
+    }
+    return shifted;
+}
+
+// Knuth's algorithm D: one limb of the quotient per step, estimated from the
+// top limbs of the divisor normalized to have its highest bit set
+void DivideModulo(View a, View b, Limbs& quotient, Limbs& remainder) {
+    if (Compare(a, b) < 0) {
+        quotient.clear();
+        remainder.assign(a.data, a.data + a.size);
+        return;
+    }
+    if (b.size == 1) {
+        quotient.assign(a.data, a.data + a.size);
+        remainder.assign(1, DivideSmall(quotient, b.data[0]));
+        Trim(remainder);
+        return;
+    }
+    int shift = 0;
+    while ((b.data[b.size - 1] << shift) >> (kLimbBits - 1) == 0) {
+        ++shift;
+    }
+    std::size_t n = b.size;
+    std::size_t m = a.size - n;
+    Limbs v = ShiftLeft(b, shift, n);
+    Limbs u = ShiftLeft(a, shift, a.size + 1);
+    quotient.assign(m + 1, 0);
+    constexpr Wide kBase = Wide{1} << kLimbBits;
+
+    for (std::size_t j = m + 1; j-- > 0;) {
+        Wide top = (static_cast<Wide>(u[j + n]) << kLimbBits) | u[j + n - 1];
+        Wide estimate = top / v[n - 1];
+        Wide rest = top % v[n - 1];
+        while (estimate >= kBase ||
+               estimate * v[n - 2] > ((rest << kLimbBits) | u[j + n - 2])) {
+            --estimate;
+            rest += v[n - 1];
+            if (rest >= kBase) {
+                break;
+            }
+        }
+
+        int64_t borrow = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            Wide p = estimate * v[i];
+            int64_t t = static_cast<int64_t>(u[i + j]) - borrow -
+                        static_cast<int64_t>(p & (kBase - 1));
+            u[i + j] = static_cast<Limb>(t);
+            borrow = static_cast<int64_t>(p >> kLimbBits) - (t >> kLimbBits);
+        }
+        int64_t t = static_cast<int64_t>(u[j + n]) - borrow;
+        u[j + n] = static_cast<Limb>(t);
+
+        // The estimate was one too large, add the divisor back
+        if (t < 0) {
+            --estimate;
+            Wide carry = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                carry += static_cast<Wide>(u[i + j]) + v[i];
+                u[i + j] = static_cast<Limb>(carry);
+                carry >>= kLimbBits;
+            }
+            u[j + n] += static_cast<Limb>(carry);
+        }
+        quotient[j] = static_cast<Limb>(estimate);
+    }
+    Trim(quotient);
+
+    remainder.assign(n, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        remainder[i] = u[i] >> shift;
+        if (shift != 0) {
+            remainder[i] |= u[i + 1] << (kLimbBits - shift);
+        }
+    }
+    Trim(remainder);
+}
+
+}  // namespace
+
+BigInteger::BigInteger(int value) : negative_(value < 0) {
+    int64_t wide = value;
+    auto magnitude = static_cast<Wide>(negative_ ? -wide : wide);
+    while (magnitude != 0) {
+        limbs_.push_back(static_cast<Limb>(magnitude));
+        magnitude >>= kLimbBits;
+    }
+}
+
+std::string BigInteger::toString() const {
+    if (limbs_.empty()) {
+        return "0";
+    }
+    // Nine decimal digits per division, from the lowest
+    Limbs magnitude = limbs_;
+    std::vector<Limb> chunks;
+    while (!magnitude.empty()) {
+        chunks.push_back(DivideSmall(magnitude, kDecimalBase));
+    }
+    std::string result = negative_ ? "-" : "";
+    result += std::to_string(chunks.back());
+    for (std::size_t i = chunks.size() - 1; i-- > 0;) {
+        std::string chunk = std::to_string(chunks[i]);
+        result.append(kDecimalDigits - chunk.size(), '0');
+        result += chunk;
+    }
+    return result;
+}
+
+BigInteger::operator bool() const {
+    return !limbs_.empty();
+}
+
+BigInteger BigInteger::operator-() const {
+    BigInteger result = *this;
+    result.negative_ = !negative_ && !limbs_.empty();
+    return result;
+}
+
+void BigInteger::AddSigned(const BigInteger& other, bool negate) {
+    bool other_negative = other.negative_ != negate;
+    if (negative_ == other_negative) {
+        limbs_ = Add(Of(limbs_), Of(other.limbs_));
+        return;
+    }
+    if (Compare(Of(limbs_), Of(other.limbs_)) >= 0) {
+        limbs_ = Subtract(Of(limbs_), Of(other.limbs_));
+    } else {
+        limbs_ = Subtract(Of(other.limbs_), Of(limbs_));
+        negative_ = other_negative;
+    }
+    Normalize();
+}
+
+void BigInteger::Normalize() {
+    Trim(limbs_);
+    if (limbs_.empty()) {
+        negative_ = false;
+    }
+}
+
+BigInteger& BigInteger::operator+=(const BigInteger& other) {
+    AddSigned(other, false);
+    return *this;
+}
+
+BigInteger& BigInteger::operator-=(const BigInteger& other) {
+    AddSigned(other, true);
+    return *this;
+}
+
+BigInteger& BigInteger::operator*=(const BigInteger& other) {
+    limbs_ = Multiply(Of(limbs_), Of(other.limbs_));
+    negative_ = negative_ != other.negative_;
+    Normalize();
+    return *this;
+}
+
+BigInteger& BigInteger::operator/=(const BigInteger& other) {
+    Limbs quotient;
+    Limbs remainder;
+    DivideModulo(Of(limbs_), Of(other.limbs_), quotient, remainder);
+    limbs_ = std::move(quotient);
+    negative_ = negative_ != other.negative_;
+    Normalize();
+    return *this;
+}
+
+BigInteger& BigInteger::operator%=(const BigInteger& other) {
+    Limbs quotient;
+    Limbs remainder;
+    DivideModulo(Of(limbs_), Of(other.limbs_), quotient, remainder);
+    limbs_ = std::move(remainder);
+    Normalize();
+    return *this;
+}
+
+BigInteger& BigInteger::operator++() {
+    if (negative_) {
+        for (Limb& limb : limbs_) {
+            if (limb-- != 0) {
+                break;
+            }
+        }
+        Normalize();
+        return *this;
+    }
+    for (Limb& limb : limbs_) {
+        if (++limb != 0) {
+            return *this;
+        }
+    }
+    limbs_.push_back(1);
+    return *this;
+}
+
+BigInteger BigInteger::operator++(int) {
+    BigInteger old = *this;
+    ++*this;
+    return old;
+}
+
+// x - 1 == -(-x + 1)
+BigInteger& BigInteger::operator--() {
+    negative_ = !negative_ && !limbs_.empty();
+    ++*this;
+    negative_ = !negative_ && !limbs_.empty();
+    return *this;
+}
+
+BigInteger BigInteger::operator--(int) {
+    BigInteger old = *this;
+    --*this;
+    return old;
+}
+
+bool operator==(const BigInteger& lhs, const BigInteger& rhs) {
+    return lhs.negative_ == rhs.negative_ && lhs.limbs_ == rhs.limbs_;
+}
+
+bool operator<(const BigInteger& lhs, const BigInteger& rhs) {
+    if (lhs.negative_ != rhs.negative_) {
+        return lhs.negative_;
+    }
+    int order = Compare(Of(lhs.limbs_), Of(rhs.limbs_));
+    return lhs.negative_ ? order > 0 : order < 0;
+}
+
+std::istream& operator>>(std::istream& in, BigInteger& value) {
+    std::string text;
+    if (!(in >> text)) {
+        return in;
+    }
+    std::size_t begin = text[0] == '-' || text[0] == '+' ? 1 : 0;
+    if (begin == text.size()) {
+        in.setstate(std::ios::failbit);
+        return in;
+    }
+    for (std::size_t i = begin; i < text.size(); ++i) {
+        if (text[i] < '0' || text[i] > '9') {
+            in.setstate(std::ios::failbit);
+            return in;
+        }
+    }
+    // Nine decimal digits per chunk, from the lowest
+    std::vector<Limb> chunks;
+    for (std::size_t end = text.size(); end > begin;) {
+        std::size_t chunk_begin = end - begin > kDecimalDigits ? end - kDecimalDigits : begin;
+        Limb chunk = 0;
+        for (std::size_t i = chunk_begin; i < end; ++i) {
+            chunk = chunk * 10 + static_cast<Limb>(text[i] - '0');
+        }
+        chunks.push_back(chunk);
+        end = chunk_begin;
+    }
+    std::vector<Limbs> powers = {{kDecimalBase}};
+    Limbs magnitude = FromDecimal(chunks.data(), chunks.size(), powers);
+    value.limbs_ = std::move(magnitude);
+    value.negative_ = text[0] == '-';
+    value.Normalize();
+    return in;
+}
+
+BigInteger operator+(BigInteger lhs, const BigInteger& rhs) {
+    return lhs += rhs;
+}
+
+BigInteger operator-(BigInteger lhs, const BigInteger& rhs) {
+    return lhs -= rhs;
+}
+
+BigInteger operator*(BigInteger lhs, const BigInteger& rhs) {
+    return lhs *= rhs;
+}
+
+BigInteger operator/(BigInteger lhs, const BigInteger& rhs) {
+    return lhs /= rhs;
+}
+
+BigInteger operator%(BigInteger lhs, const BigInteger& rhs) {
+    return lhs %= rhs;
+}
+
+bool operator!=(const BigInteger& lhs, const BigInteger& rhs) {
+    return !(lhs == rhs);
+}
+
+bool operator>(const BigInteger& lhs, const BigInteger& rhs) {
+    return rhs < lhs;
+}
+
+bool operator<=(const BigInteger& lhs, const BigInteger& rhs) {
+    return !(rhs < lhs);
+}
+
+bool operator>=(const BigInteger& lhs, const BigInteger& rhs) {
+    return !(lhs < rhs);
+}
+
+std::ostream& operator<<(std::ostream& out, const BigInteger& value) {
+    return out << value.toString();
+}
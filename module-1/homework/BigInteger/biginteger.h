@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Signed integer of any length, with the semantics of int: division
+// truncates toward zero and the remainder has the sign of the dividend
+class BigInteger {
+public:
+    BigInteger() = default;
+    BigInteger(int value);  // NOLINT
+
+    std::string toString() const;  // NOLINT
+
+    explicit operator bool() const;
+
+    BigInteger operator-() const;
+
+    BigInteger& operator+=(const BigInteger& other);
+    BigInteger& operator-=(const BigInteger& other);
+    BigInteger& operator*=(const BigInteger& other);
+    BigInteger& operator/=(const BigInteger& other);
+    BigInteger& operator%=(const BigInteger& other);
+
+    // O(1) on average: the carry rarely goes past the lowest limb
+    BigInteger& operator++();
+    BigInteger operator++(int);
+    BigInteger& operator--();
+    BigInteger operator--(int);
+
+    friend bool operator==(const BigInteger& lhs, const BigInteger& rhs);
+    friend bool operator<(const BigInteger& lhs, const BigInteger& rhs);
+
+    friend std::istream& operator>>(std::istream& in, BigInteger& value);
+
+private:
+    // Adds other, or subtracts it if negate is set
+    void AddSigned(const BigInteger& other, bool negate);
+    // Drops the leading zero limbs, zero is never negative
+    void Normalize();
+
+    // The magnitude in base 2^32, least significant limb first
+    std::vector<uint32_t> limbs_;
+    bool negative_ = false;
+};
+
+BigInteger operator+(BigInteger lhs, const BigInteger& rhs);
+BigInteger operator-(BigInteger lhs, const BigInteger& rhs);
+BigInteger operator*(BigInteger lhs, const BigInteger& rhs);
+BigInteger operator/(BigInteger lhs, const BigInteger& rhs);
+BigInteger operator%(BigInteger lhs, const BigInteger& rhs);
+
+bool operator!=(const BigInteger& lhs, const BigInteger& rhs);
+bool operator>(const BigInteger& lhs, const BigInteger& rhs);
+bool operator<=(const BigInteger& lhs, const BigInteger& rhs);
+bool operator>=(const BigInteger& lhs, const BigInteger& rhs);
+
+std::ostream& operator<<(std::ostream& out, const BigInteger& value);
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <iostream>
+#include <random>
 #include <stdexcept>
 #include <string>
 #include <sstream>
@@ -104,6 +105,137 @@ TEST(Comparison, Test1) {
     ASSERT_EQ(oss.str(), "010101");
 }
 
+// Random decimal number with the given count of digits
+std::string RandomDigits(std::mt19937& random, std::size_t digits) {
+    std::uniform_int_distribution<int> digit(0, 9);
+    std::string result(1, static_cast<char>('1' + digit(random) % 9));
+    while (result.size() < digits) {
+        result += static_cast<char>('0' + digit(random));
+    }
+    return result;
+}
+
+BigInteger Parse(const std::string& text) {
+    std::istringstream iss(text);
+    BigInteger result;
+    iss >> result;
+    return result;
+}
+
+// Schoolbook multiplication of decimal strings, the reference for the
+// Karatsuba and Toom-3 paths
+std::string MultiplyDecimal(const std::string& a, const std::string& b) {
+    std::vector<int> digits(a.size() + b.size());
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        for (std::size_t j = 0; j < b.size(); ++j) {
+            digits[i + j + 1] += (a[i] - '0') * (b[j] - '0');
+        }
+    }
+    for (std::size_t i = digits.size() - 1; i > 0; --i) {
+        digits[i - 1] += digits[i] / 10;
+        digits[i] %= 10;
+    }
+    std::string result;
+    for (int digit : digits) {
+        if (!result.empty() || digit != 0) {
+            result += static_cast<char>('0' + digit);
+        }
+    }
+    return result.empty() ? "0" : result;
+}
+
+TEST(Multiplication, Random) {
+    std::mt19937 random(42);
+    const std::vector<std::pair<std::size_t, std::size_t>> sizes = {
+        {1, 1},       {20, 9},      {300, 300},   {700, 650},  {1000, 400},
+        {2000, 1900}, {3000, 1700}, {5000, 4999}, {6000, 800}, {4000, 30}};
+    for (auto [a_digits, b_digits] : sizes) {
+        std::string a = RandomDigits(random, a_digits);
+        std::string b = RandomDigits(random, b_digits);
+        std::string product = MultiplyDecimal(a, b);
+        ASSERT_EQ((Parse(a) * Parse(b)).toString(), product);
+        ASSERT_EQ((Parse("-" + a) * Parse(b)).toString(), "-" + product);
+        ASSERT_EQ((Parse(b) * Parse("-" + a)).toString(), "-" + product);
+    }
+}
+
+// Powers of two minus one: every limb is full and every carry propagates
+TEST(Multiplication, Carries) {
+    BigInteger all_ones = 1;
+    for (int i = 0; i < 32 * 700; ++i) {
+        all_ones *= 2;
+    }
+    --all_ones;
+    BigInteger square = all_ones * all_ones;
+    ASSERT_EQ(square + 2 * all_ones + 1, (all_ones + 1) * (all_ones + 1));
+    ASSERT_EQ(square / all_ones, all_ones);
+    ASSERT_FALSE(square % all_ones);
+}
+
+// Above the threshold of the number-theoretic transform, checked by the
+// independent long division and by products of smaller, Toom-3 sizes
+TEST(Multiplication, Huge) {
+    std::mt19937 random(3);
+    for (auto [a_digits, b_digits] :
+         {std::pair<std::size_t, std::size_t>{40000, 35000}, {70000, 31000}}) {
+        std::string a_text = RandomDigits(random, a_digits);
+        BigInteger a = Parse(a_text);
+        BigInteger b = Parse(RandomDigits(random, b_digits));
+        BigInteger c = Parse(RandomDigits(random, 3000));
+        BigInteger product = a * b;
+        ASSERT_EQ(a.toString(), a_text);
+        ASSERT_EQ(product / b, a);
+        ASSERT_FALSE(product % b);
+        ASSERT_EQ(a * (b + c), product + a * c);
+        ASSERT_EQ(a * a, (a - c) * (a + c) + c * c);
+    }
+
+    // Full limbs give the largest coefficients, (2^n - 1)^2 = 2^2n - 2^(n + 1) + 1
+    BigInteger power = 1;
+    for (int i = 0; i < 4096; ++i) {
+        power *= 1 << 16;
+        power *= 1 << 16;
+    }
+    BigInteger all_ones = power - 1;
+    ASSERT_EQ(all_ones * all_ones, power * power - 2 * power + 1);
+}
+
+TEST(Division, Random) {
+    std::mt19937 random(7);
+    std::uniform_int_distribution<std::size_t> length(1, 1500);
+    for (int i = 0; i < 50; ++i) {
+        BigInteger a = Parse((i % 2 == 0 ? "" : "-") + RandomDigits(random, length(random)));
+        BigInteger b = Parse((i % 3 == 0 ? "-" : "") + RandomDigits(random, length(random)));
+        BigInteger quotient = a / b;
+        BigInteger remainder = a % b;
+        ASSERT_EQ(quotient * b + remainder, a);
+        ASSERT_TRUE(remainder >= 0 ? remainder < (b < 0 ? -b : b) : -remainder < (b < 0 ? -b : b));
+        ASSERT_TRUE(!remainder || (remainder < 0) == (a < 0));
+    }
+}
+
+// Small values behave exactly as int
+TEST(Arithmetic, RandomInts) {
+    std::mt19937 random(1);
+    std::uniform_int_distribution<int> value(-46340, 46340);
+    for (int i = 0; i < 1000; ++i) {
+        int a = value(random);
+        int b = value(random);
+        BigInteger x = a;
+        BigInteger y = b;
+        ASSERT_EQ((x + y).toString(), std::to_string(a + b));
+        ASSERT_EQ((x - y).toString(), std::to_string(a - b));
+        ASSERT_EQ((x * y).toString(), std::to_string(a * b));
+        ASSERT_EQ(x < y, a < b);
+        if (b != 0) {
+            ASSERT_EQ((x / y).toString(), std::to_string(a / b));
+            ASSERT_EQ((x % y).toString(), std::to_string(a % b));
+        }
+        ASSERT_EQ((--x).toString(), std::to_string(a - 1));
+        ASSERT_EQ((++++x).toString(), std::to_string(a + 1));
+    }
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
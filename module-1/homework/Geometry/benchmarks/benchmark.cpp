@@ -0,0 +1,68 @@
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "../hierarchy/point.h"
+#include "../hierarchy/polygon.h"
+#include "benchmark/benchmark.h"
+
+// Regular polygon with range(0) vertices inscribed in the unit circle
+std::vector<Point> RegularPolygon(benchmark::State& state) {
+    std::vector<Point> vertices;
+    const double step = 2 * M_PI / static_cast<double>(state.range(0));
+    for (int64_t i = 0; i < state.range(0); i++) {
+        vertices.emplace_back(std::cos(step * i), std::sin(step * i));
+    }
+    return vertices;
+}
+
+void Area(benchmark::State& state) {
+    Polygon polygon(RegularPolygon(state));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(polygon.area());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void Perimeter(benchmark::State& state) {
+    Polygon polygon(RegularPolygon(state));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(polygon.perimeter());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void IsConvex(benchmark::State& state) {
+    Polygon polygon(RegularPolygon(state));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(polygon.isConvex());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void ContainsPoint(benchmark::State& state) {
+    Polygon polygon(RegularPolygon(state));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(polygon.containsPoint(Point(0.25, 0.5)));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void Transform(benchmark::State& state) {
+    Polygon polygon(RegularPolygon(state));
+    for (auto _ : state) {
+        polygon.rotate(Point(0, 0), 45);
+        polygon.scale(Point(0, 0), 2);
+        polygon.scale(Point(0, 0), 0.5);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Area)->Range(4, 1 << 16);
+BENCHMARK(Perimeter)->Range(4, 1 << 16);
+BENCHMARK(IsConvex)->Range(4, 1 << 16);
+BENCHMARK(ContainsPoint)->Range(4, 1 << 16);
+BENCHMARK(Transform)->Range(4, 1 << 16);
+
+BENCHMARK_MAIN();
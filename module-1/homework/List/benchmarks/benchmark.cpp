@@ -0,0 +1,106 @@
+#include <cstdint>
+#include <list>
+#include <random>
+
+#include "../list.h"
+#include "benchmark/benchmark.h"
+
+// Every benchmark runs on task::list and on std::list<int> with the same
+// operations, so the pairs in the report read as task vs std
+
+void FillRandom(task::list& list, int64_t count) {
+    std::mt19937 random_engine(42);
+    for (int64_t i = 0; i < count; i++) {
+        list.push_back(static_cast<int>(random_engine() % 1000));
+    }
+}
+
+void FillRandom(std::list<int>& list, int64_t count) {
+    std::mt19937 random_engine(42);
+    for (int64_t i = 0; i < count; i++) {
+        list.push_back(static_cast<int>(random_engine() % 1000));
+    }
+}
+
+template <typename List>
+void PushBack(benchmark::State& state) {
+    for (auto _ : state) {
+        List list;
+        for (int64_t i = 0; i < state.range(0); i++) {
+            list.push_back(static_cast<int>(i));
+        }
+        benchmark::DoNotOptimize(list.back());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename List>
+void PushPopFront(benchmark::State& state) {
+    List list;
+    for (auto _ : state) {
+        for (int64_t i = 0; i < state.range(0); i++) {
+            list.push_front(static_cast<int>(i));
+        }
+        while (!list.empty()) {
+            list.pop_front();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename List>
+void Sort(benchmark::State& state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        List list;
+        FillRandom(list, state.range(0));
+        state.ResumeTiming();
+        list.sort();
+        benchmark::DoNotOptimize(list.front());
+        state.PauseTiming();
+        list.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename List>
+void RemoveUnique(benchmark::State& state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        List list;
+        FillRandom(list, state.range(0));
+        state.ResumeTiming();
+        list.remove(7);
+        list.unique();
+        benchmark::DoNotOptimize(list.size());
+        state.PauseTiming();
+        list.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename List>
+void Copy(benchmark::State& state) {
+    List list;
+    FillRandom(list, state.range(0));
+    for (auto _ : state) {
+        List copy = list;
+        benchmark::DoNotOptimize(copy.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(PushBack, task::list)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(PushBack, std::list<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(PushPopFront, task::list)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(PushPopFront, std::list<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(Sort, task::list)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(Sort, std::list<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(RemoveUnique, task::list)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(RemoveUnique, std::list<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(Copy, task::list)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(Copy, std::list<int>)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_MAIN();
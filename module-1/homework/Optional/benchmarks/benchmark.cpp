@@ -0,0 +1,164 @@
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../optional.h"
+#include "benchmark/benchmark.h"
+
+// Adapters over the two implementations, every benchmark runs once for each
+struct Task {
+    template <typename T>
+    using Optional = task::Optional<T>;
+
+    template <typename T>
+    static bool HasValue(const Optional<T>& optional) {
+        return optional.HasValue();
+    }
+    template <typename T, typename U>
+    static T ValueOr(const Optional<T>& optional, U&& value) {
+        return optional.ValueOr(std::forward<U>(value));
+    }
+    template <typename T>
+    static void Reset(Optional<T>& optional) {
+        optional.Reset();
+    }
+};
+
+struct Std {
+    template <typename T>
+    using Optional = std::optional<T>;
+
+    template <typename T>
+    static bool HasValue(const Optional<T>& optional) {
+        return optional.has_value();
+    }
+    template <typename T, typename U>
+    static T ValueOr(const Optional<T>& optional, U&& value) {
+        return optional.value_or(std::forward<U>(value));
+    }
+    template <typename T>
+    static void Reset(Optional<T>& optional) {
+        optional.reset();
+    }
+};
+
+template <typename Impl>
+void EmplaceReset(benchmark::State& state) {
+    typename Impl::template Optional<std::string> optional;
+    for (auto _ : state) {
+        optional = std::string("hello");
+        benchmark::DoNotOptimize(optional->size());
+        Impl::Reset(optional);
+    }
+}
+
+// Every other element is empty, so the branch on HasValue is unpredictable
+template <typename Impl>
+void ValueOr(benchmark::State& state) {
+    std::vector<typename Impl::template Optional<int64_t>> values(
+        static_cast<std::size_t>(state.range(0)));
+    for (std::size_t i = 0; i < values.size(); i += 2) {
+        values[i] = static_cast<int64_t>(i);
+    }
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (const auto& value : values) {
+            sum += Impl::ValueOr(value, int64_t{1});
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Impl>
+void Count(benchmark::State& state) {
+    std::vector<typename Impl::template Optional<int64_t>> values(
+        static_cast<std::size_t>(state.range(0)));
+    for (std::size_t i = 0; i < values.size(); i += 3) {
+        values[i] = static_cast<int64_t>(i);
+    }
+    for (auto _ : state) {
+        int64_t count = 0;
+        for (const auto& value : values) {
+            count += Impl::HasValue(value) ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// A pointer that is never null, so null is free to be its niche
+struct NonNull {
+    struct NicheAccess;
+    using niche_traits = NicheAccess;
+
+    const int64_t* ptr;
+};
+
+struct NonNull::NicheAccess {
+    static constexpr NonNull Niche() noexcept {
+        return {nullptr};
+    }
+    static constexpr bool IsNiche(NonNull value) noexcept {
+        return value.ptr == nullptr;
+    }
+};
+
+// A table of pointers into a small array: task::Optional<NonNull> keeps the
+// empty state in the pointer and the table has half the size
+template <typename Impl>
+void ScanPointers(benchmark::State& state) {
+    using Entry = typename Impl::template Optional<NonNull>;
+    std::vector<int64_t> targets(64, 1);
+    std::vector<Entry> table(static_cast<std::size_t>(state.range(0)));
+    for (std::size_t i = 0; i < table.size(); i += 4) {
+        table[i] = NonNull{&targets[i % targets.size()]};
+    }
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (const auto& entry : table) {
+            if (Impl::HasValue(entry)) {
+                sum += *entry->ptr;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) *
+                            static_cast<int64_t>(sizeof(Entry)));
+}
+
+// A trivially copyable Optional<int32_t> comes back in a register
+template <typename Impl>
+[[gnu::noinline]] typename Impl::template Optional<int32_t> Half(int32_t x) {
+    if (x % 2 != 0) {
+        return {};
+    }
+    return typename Impl::template Optional<int32_t>(x / 2);
+}
+
+template <typename Impl>
+void ReturnByValue(benchmark::State& state) {
+    for (auto _ : state) {
+        int32_t sum = 0;
+        for (int32_t i = 0; i < 1024; ++i) {
+            sum += Impl::ValueOr(Half<Impl>(i), 0);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+
+BENCHMARK_TEMPLATE(EmplaceReset, Task);
+BENCHMARK_TEMPLATE(EmplaceReset, Std);
+BENCHMARK_TEMPLATE(ValueOr, Task)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(ValueOr, Std)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(Count, Task)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(Count, Std)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(ScanPointers, Task)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(ScanPointers, Std)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(ReturnByValue, Task);
+BENCHMARK_TEMPLATE(ReturnByValue, Std);
+
+BENCHMARK_MAIN();
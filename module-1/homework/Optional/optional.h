@@ -1,64 +1,665 @@
 #include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
 #include <type_traits>
+#include <utility>
 
 #pragma once
 
 namespace task {
 
 struct NullOpt {
-    // Your code goes here;
+    explicit constexpr NullOpt(int) {
+    }
 };
 
-constexpr NullOpt kNullOpt = // Your code goes here;
+constexpr NullOpt kNullOpt = NullOpt(0);
 
 struct InPlace {
-    // Your code goes here;
+    explicit InPlace() = default;
 };
 
-constexpr InPlace kInPlace =  //Your code goes here;
+constexpr InPlace kInPlace = InPlace();
 
 template <typename T>
-class Optional : public // Your code goes here; {
+class Optional;
+
+// A niche is a value of T which Optional<T> never stores, so it marks the
+// empty state instead of a flag and Optional<T> has the size of T. A type
+// gets one by a specialization of NicheTraits or by a nested niche_traits,
+// both with
+//     static T Niche();                  // makes the niche, must not throw
+//     static bool IsNiche(const T& value);
+// Optional<T> must not be given the niche itself. Raw pointers have none:
+// every address may be stored, and a made-up one such as 1 is not a constant
+// expression, so Optional<T*> would stop being constexpr
+template <typename T, typename = void>
+struct NicheTraits {};
+
+template <typename T>
+struct NicheTraits<T, std::void_t<typename T::niche_traits>> : T::niche_traits {};
+
+namespace detail {
+
+// Constructs the value from the result of a call, which is then not moved
+struct InvokeTag {};
+
+template <typename T, typename = void>
+constexpr bool kHasNiche = false;
+
+template <typename T>
+constexpr bool kHasNiche<T, std::void_t<decltype(NicheTraits<T>::Niche())>> = true;
+
+// Storage is layered as in libc++: every layer adds one special member
+// function, and only when T makes it non-trivial. Otherwise the layer keeps
+// the implicit one, so Optional<int> is trivially copyable and is passed and
+// returned in registers
+
+// The value and the flag. A trivially destructible T keeps the destructor
+// trivial and Optional<T> a literal type
+template <typename T, bool = std::is_trivially_destructible_v<T>, bool = kHasNiche<T>>
+struct OptionalPayload {
+    constexpr OptionalPayload() noexcept : dummy(), engaged(false) {
+    }
+
+    template <typename... Args>
+    constexpr explicit OptionalPayload(InPlace, Args&&... args)
+        : value(std::forward<Args>(args)...), engaged(true) {
+    }
+
+    template <typename F, typename Arg>
+    constexpr OptionalPayload(InvokeTag, F&& f, Arg&& arg)
+        : value(std::invoke(std::forward<F>(f), std::forward<Arg>(arg))), engaged(true) {
+    }
+
+    constexpr bool Engaged() const noexcept {
+        return engaged;
+    }
+
+    template <typename... Args>
+    void Construct(Args&&... args) {
+        ::new (static_cast<void*>(std::addressof(value))) T(std::forward<Args>(args)...);
+        engaged = true;
+    }
+
+    void Destroy() noexcept {
+        engaged = false;
+    }
+
+    union {
+        char dummy;
+        T value;
+    };
+    bool engaged;
+};
+
+template <typename T>
+struct OptionalPayload<T, false, false> {
+    constexpr OptionalPayload() noexcept : dummy(), engaged(false) {
+    }
+
+    template <typename... Args>
+    constexpr explicit OptionalPayload(InPlace, Args&&... args)
+        : value(std::forward<Args>(args)...), engaged(true) {
+    }
+
+    template <typename F, typename Arg>
+    constexpr OptionalPayload(InvokeTag, F&& f, Arg&& arg)
+        : value(std::invoke(std::forward<F>(f), std::forward<Arg>(arg))), engaged(true) {
+    }
+
+    OptionalPayload(const OptionalPayload&) = default;
+    OptionalPayload(OptionalPayload&&) = default;
+    OptionalPayload& operator=(const OptionalPayload&) = default;
+    OptionalPayload& operator=(OptionalPayload&&) = default;
+
+    ~OptionalPayload() {
+        Destroy();
+    }
+
+    constexpr bool Engaged() const noexcept {
+        return engaged;
+    }
+
+    template <typename... Args>
+    void Construct(Args&&... args) {
+        ::new (static_cast<void*>(std::addressof(value))) T(std::forward<Args>(args)...);
+        engaged = true;
+    }
+
+    void Destroy() noexcept {
+        if (engaged) {
+            value.~T();
+            engaged = false;
+        }
+    }
+
+    union {
+        char dummy;
+        T value;
+    };
+    bool engaged;
+};
+
+// No flag: an empty payload holds the niche of T. The niche object is never
+// destroyed, it owns nothing
+template <typename T>
+struct OptionalPayload<T, true, true> {
+    constexpr OptionalPayload() noexcept : value(NicheTraits<T>::Niche()) {
+    }
+
+    template <typename... Args>
+    constexpr explicit OptionalPayload(InPlace, Args&&... args)
+        : value(std::forward<Args>(args)...) {
+    }
+
+    template <typename F, typename Arg>
+    constexpr OptionalPayload(InvokeTag, F&& f, Arg&& arg)
+        : value(std::invoke(std::forward<F>(f), std::forward<Arg>(arg))) {
+    }
+
+    constexpr bool Engaged() const noexcept {
+        return !NicheTraits<T>::IsNiche(value);
+    }
+
+    // The value is built over the niche. If that throws, the storage may hold
+    // a half-built T which Engaged would take for a value, so the niche is
+    // put back first
+    template <typename... Args>
+    void Construct(Args&&... args) {
+        try {
+            ::new (static_cast<void*>(std::addressof(value))) T(std::forward<Args>(args)...);
+        } catch (...) {
+            ::new (static_cast<void*>(std::addressof(value))) T(NicheTraits<T>::Niche());
+            throw;
+        }
+    }
+
+    void Destroy() noexcept {
+        ::new (static_cast<void*>(std::addressof(value))) T(NicheTraits<T>::Niche());
+    }
+
+    union {
+        T value;
+    };
+};
+
+template <typename T>
+struct OptionalPayload<T, false, true> {
+    OptionalPayload() noexcept : value(NicheTraits<T>::Niche()) {
+    }
+
+    template <typename... Args>
+    explicit OptionalPayload(InPlace, Args&&... args) : value(std::forward<Args>(args)...) {
+    }
+
+    template <typename F, typename Arg>
+    OptionalPayload(InvokeTag, F&& f, Arg&& arg)
+        : value(std::invoke(std::forward<F>(f), std::forward<Arg>(arg))) {
+    }
+
+    OptionalPayload(const OptionalPayload&) = default;
+    OptionalPayload(OptionalPayload&&) = default;
+    OptionalPayload& operator=(const OptionalPayload&) = default;
+    OptionalPayload& operator=(OptionalPayload&&) = default;
+
+    ~OptionalPayload() {
+        if (Engaged()) {
+            value.~T();
+        }
+    }
+
+    bool Engaged() const noexcept {
+        return !NicheTraits<T>::IsNiche(value);
+    }
+
+    template <typename... Args>
+    void Construct(Args&&... args) {
+        try {
+            ::new (static_cast<void*>(std::addressof(value))) T(std::forward<Args>(args)...);
+        } catch (...) {
+            ::new (static_cast<void*>(std::addressof(value))) T(NicheTraits<T>::Niche());
+            throw;
+        }
+    }
+
+    void Destroy() noexcept {
+        if (Engaged()) {
+            value.~T();
+            ::new (static_cast<void*>(std::addressof(value))) T(NicheTraits<T>::Niche());
+        }
+    }
+
+    union {
+        T value;
+    };
+};
+
+// Access to the value and the operations the upper layers are built from.
+// The payload is a member and not a base: GCC keeps a returned Optional<int>
+// in a register only when its fields are not inherited
+template <typename T>
+class OptionalStorageBase {
+protected:
+    constexpr OptionalStorageBase() noexcept = default;
+
+    template <typename... Args>
+    constexpr explicit OptionalStorageBase(InPlace, Args&&... args)
+        : payload_(kInPlace, std::forward<Args>(args)...) {
+    }
+
+    template <typename F, typename Arg>
+    constexpr OptionalStorageBase(InvokeTag, F&& f, Arg&& arg)
+        : payload_(InvokeTag(), std::forward<F>(f), std::forward<Arg>(arg)) {
+    }
+
+    constexpr bool Engaged() const noexcept {
+        return payload_.Engaged();
+    }
+
+    constexpr T& Get() & noexcept {
+        return payload_.value;
+    }
+    constexpr const T& Get() const& noexcept {
+        return payload_.value;
+    }
+    constexpr T&& Get() && noexcept {
+        return std::move(payload_.value);
+    }
+    constexpr const T&& Get() const&& noexcept {
+        return std::move(payload_.value);
+    }
+
+    template <typename... Args>
+    void Construct(Args&&... args) {
+        payload_.Construct(std::forward<Args>(args)...);
+    }
+
+    void Destroy() noexcept {
+        payload_.Destroy();
+    }
+
+    template <typename That>
+    void ConstructFrom(That&& other) {
+        if (other.Engaged()) {
+            Construct(std::forward<That>(other).Get());
+        }
+    }
+
+    template <typename That>
+    void AssignFrom(That&& other) {
+        if (Engaged() == other.Engaged()) {
+            if (Engaged()) {
+                Get() = std::forward<That>(other).Get();
+            }
+        } else if (Engaged()) {
+            Destroy();
+        } else {
+            Construct(std::forward<That>(other).Get());
+        }
+    }
+
+private:
+    OptionalPayload<T> payload_;
+};
+
+template <typename T, bool = std::is_trivially_copy_constructible_v<T>>
+class OptionalCopyBase : public OptionalStorageBase<T> {
+protected:
+    using OptionalStorageBase<T>::OptionalStorageBase;
+};
+
+template <typename T>
+class OptionalCopyBase<T, false> : public OptionalStorageBase<T> {
+protected:
+    using OptionalStorageBase<T>::OptionalStorageBase;
+
+    OptionalCopyBase() = default;
+    OptionalCopyBase(const OptionalCopyBase& other) {
+        this->ConstructFrom(other);
+    }
+    OptionalCopyBase(OptionalCopyBase&&) = default;
+    OptionalCopyBase& operator=(const OptionalCopyBase&) = default;
+    OptionalCopyBase& operator=(OptionalCopyBase&&) = default;
+};
+
+template <typename T, bool = std::is_trivially_move_constructible_v<T>>
+class OptionalMoveBase : public OptionalCopyBase<T> {
+protected:
+    using OptionalCopyBase<T>::OptionalCopyBase;
+};
+
+template <typename T>
+class OptionalMoveBase<T, false> : public OptionalCopyBase<T> {
+protected:
+    using OptionalCopyBase<T>::OptionalCopyBase;
+
+    OptionalMoveBase() = default;
+    OptionalMoveBase(const OptionalMoveBase&) = default;
+    OptionalMoveBase(OptionalMoveBase&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        this->ConstructFrom(std::move(other));
+    }
+    OptionalMoveBase& operator=(const OptionalMoveBase&) = default;
+    OptionalMoveBase& operator=(OptionalMoveBase&&) = default;
+};
+
+template <typename T, bool = std::is_trivially_destructible_v<T> &&
+                             std::is_trivially_copy_constructible_v<T> &&
+                             std::is_trivially_copy_assignable_v<T>>
+class OptionalCopyAssignBase : public OptionalMoveBase<T> {
+protected:
+    using OptionalMoveBase<T>::OptionalMoveBase;
+};
+
+template <typename T>
+class OptionalCopyAssignBase<T, false> : public OptionalMoveBase<T> {
+protected:
+    using OptionalMoveBase<T>::OptionalMoveBase;
+
+    OptionalCopyAssignBase() = default;
+    OptionalCopyAssignBase(const OptionalCopyAssignBase&) = default;
+    OptionalCopyAssignBase(OptionalCopyAssignBase&&) = default;
+    OptionalCopyAssignBase& operator=(const OptionalCopyAssignBase& other) {
+        this->AssignFrom(other);
+        return *this;
+    }
+    OptionalCopyAssignBase& operator=(OptionalCopyAssignBase&&) = default;
+};
+
+template <typename T, bool = std::is_trivially_destructible_v<T> &&
+                             std::is_trivially_move_constructible_v<T> &&
+                             std::is_trivially_move_assignable_v<T>>
+class OptionalMoveAssignBase : public OptionalCopyAssignBase<T> {
+protected:
+    using OptionalCopyAssignBase<T>::OptionalCopyAssignBase;
+};
+
+template <typename T>
+class OptionalMoveAssignBase<T, false> : public OptionalCopyAssignBase<T> {
+protected:
+    using OptionalCopyAssignBase<T>::OptionalCopyAssignBase;
+
+    OptionalMoveAssignBase() = default;
+    OptionalMoveAssignBase(const OptionalMoveAssignBase&) = default;
+    OptionalMoveAssignBase(OptionalMoveAssignBase&&) = default;
+    OptionalMoveAssignBase& operator=(const OptionalMoveAssignBase&) = default;
+    OptionalMoveAssignBase& operator=(OptionalMoveAssignBase&& other) noexcept(
+        std::is_nothrow_move_assignable_v<T>&& std::is_nothrow_move_constructible_v<T>) {
+        this->AssignFrom(std::move(other));
+        return *this;
+    }
+};
+
+// Deletes the copies and moves which T does not have
+template <bool Copy, bool Move>
+struct OptionalCtorBase {};
+
+template <>
+struct OptionalCtorBase<false, true> {
+    OptionalCtorBase() = default;
+    OptionalCtorBase(const OptionalCtorBase&) = delete;
+    OptionalCtorBase(OptionalCtorBase&&) = default;
+    OptionalCtorBase& operator=(const OptionalCtorBase&) = default;
+    OptionalCtorBase& operator=(OptionalCtorBase&&) = default;
+};
+
+template <>
+struct OptionalCtorBase<true, false> {
+    OptionalCtorBase() = default;
+    OptionalCtorBase(const OptionalCtorBase&) = default;
+    OptionalCtorBase(OptionalCtorBase&&) = delete;
+    OptionalCtorBase& operator=(const OptionalCtorBase&) = default;
+    OptionalCtorBase& operator=(OptionalCtorBase&&) = default;
+};
+
+template <>
+struct OptionalCtorBase<false, false> {
+    OptionalCtorBase() = default;
+    OptionalCtorBase(const OptionalCtorBase&) = delete;
+    OptionalCtorBase(OptionalCtorBase&&) = delete;
+    OptionalCtorBase& operator=(const OptionalCtorBase&) = default;
+    OptionalCtorBase& operator=(OptionalCtorBase&&) = default;
+};
+
+template <bool Copy, bool Move>
+struct OptionalAssignBase {};
+
+template <>
+struct OptionalAssignBase<false, true> {
+    OptionalAssignBase() = default;
+    OptionalAssignBase(const OptionalAssignBase&) = default;
+    OptionalAssignBase(OptionalAssignBase&&) = default;
+    OptionalAssignBase& operator=(const OptionalAssignBase&) = delete;
+    OptionalAssignBase& operator=(OptionalAssignBase&&) = default;
+};
+
+template <>
+struct OptionalAssignBase<true, false> {
+    OptionalAssignBase() = default;
+    OptionalAssignBase(const OptionalAssignBase&) = default;
+    OptionalAssignBase(OptionalAssignBase&&) = default;
+    OptionalAssignBase& operator=(const OptionalAssignBase&) = default;
+    OptionalAssignBase& operator=(OptionalAssignBase&&) = delete;
+};
+
+template <>
+struct OptionalAssignBase<false, false> {
+    OptionalAssignBase() = default;
+    OptionalAssignBase(const OptionalAssignBase&) = default;
+    OptionalAssignBase(OptionalAssignBase&&) = default;
+    OptionalAssignBase& operator=(const OptionalAssignBase&) = delete;
+    OptionalAssignBase& operator=(OptionalAssignBase&&) = delete;
+};
+
+template <typename T>
+using OptionalCtorBaseFor =
+    OptionalCtorBase<std::is_copy_constructible_v<T>, std::is_move_constructible_v<T>>;
+
+template <typename T>
+using OptionalAssignBaseFor =
+    OptionalAssignBase<std::is_copy_constructible_v<T> && std::is_copy_assignable_v<T>,
+                       std::is_move_constructible_v<T> && std::is_move_assignable_v<T>>;
+
+template <typename T>
+constexpr bool kIsOptional = false;
+
+template <typename T>
+constexpr bool kIsOptional<Optional<T>> = true;
+
+}  // namespace detail
+
+template <typename T>
+class Optional : public detail::OptionalMoveAssignBase<T>,
+                 private detail::OptionalCtorBaseFor<T>,
+                 private detail::OptionalAssignBaseFor<T> {
+    using Base = detail::OptionalMoveAssignBase<T>;
+
+    // The value constructor and assignment take what T is made from, except
+    // the tags and other Optionals
+    template <typename U>
+    static constexpr bool kFromValue =
+        std::is_constructible_v<T, U> && !std::is_same_v<std::decay_t<U>, InPlace> &&
+        !std::is_same_v<std::decay_t<U>, NullOpt> && !std::is_same_v<std::decay_t<U>, Optional>;
+
 public:
-    using value_type =  // Your code goes here;
+    using value_type = T;
 
-    constexpr Optional() noexcept;
+    constexpr Optional() noexcept = default;
 
-    template <typename U = value_type>
-    constexpr explicit Optional(U&& value);
+    template <typename U = value_type, typename = std::enable_if_t<kFromValue<U>>>
+    constexpr explicit Optional(U&& value) : Base(kInPlace, std::forward<U>(value)) {
+    }
 
-    constexpr explicit Optional(NullOpt) noexcept;
+    constexpr explicit Optional(NullOpt) noexcept {
+    }
 
     template <typename... Args>
-    constexpr explicit Optional(InPlace, Args&&... args);
+    constexpr explicit Optional(InPlace, Args&&... args)
+        : Base(kInPlace, std::forward<Args>(args)...) {
+    }
 
-    Optional& operator=(NullOpt) noexcept;
+    Optional& operator=(NullOpt) noexcept {
+        Reset();
+        return *this;
+    }
 
-    template <typename U = T>
-    Optional& operator=(U&& value);
+    template <typename U = T, typename = std::enable_if_t<kFromValue<U> &&
+                                                         std::is_assignable_v<T&, U>>>
+    Optional& operator=(U&& value) {
+        if (HasValue()) {
+            this->Get() = std::forward<U>(value);
+        } else {
+            this->Construct(std::forward<U>(value));
+        }
+        return *this;
+    }
 
-    void Reset() noexcept;
+    void Reset() noexcept {
+        this->Destroy();
+    }
 
     template <typename U>
-    constexpr T ValueOr(U&& default_value) const&;
+    constexpr T ValueOr(U&& default_value) const& {
+        return HasValue() ? this->Get() : static_cast<T>(std::forward<U>(default_value));
+    }
 
     template <typename U>
-    constexpr T ValueOr(U&& default_value) &&;
+    constexpr T ValueOr(U&& default_value) && {
+        return HasValue() ? std::move(this->Get()) : static_cast<T>(std::forward<U>(default_value));
+    }
+
+    // Monadic operations pass the value to f as *this is qualified, so a
+    // chain on an rvalue neither copies nor moves it
+
+    // f returns an Optional, which is the result
+    template <typename F>
+    constexpr auto AndThen(F&& f) & {
+        return AndThenImpl(*this, std::forward<F>(f));
+    }
+
+    template <typename F>
+    constexpr auto AndThen(F&& f) const& {
+        return AndThenImpl(*this, std::forward<F>(f));
+    }
+
+    template <typename F>
+    constexpr auto AndThen(F&& f) && {
+        return AndThenImpl(std::move(*this), std::forward<F>(f));
+    }
+
+    template <typename F>
+    constexpr auto AndThen(F&& f) const&& {
+        return AndThenImpl(std::move(*this), std::forward<F>(f));
+    }
+
+    // The result of f is constructed right in the returned Optional
+    template <typename F>
+    constexpr auto Transform(F&& f) & {
+        return TransformImpl(*this, std::forward<F>(f));
+    }
+
+    template <typename F>
+    constexpr auto Transform(F&& f) const& {
+        return TransformImpl(*this, std::forward<F>(f));
+    }
+
+    template <typename F>
+    constexpr auto Transform(F&& f) && {
+        return TransformImpl(std::move(*this), std::forward<F>(f));
+    }
 
-    constexpr bool HasValue() const noexcept;
+    template <typename F>
+    constexpr auto Transform(F&& f) const&& {
+        return TransformImpl(std::move(*this), std::forward<F>(f));
+    }
 
-    constexpr explicit operator bool() const noexcept;
+    // f is called without arguments for an empty Optional and returns the
+    // replacement
+    template <typename F>
+    constexpr Optional OrElse(F&& f) const& {
+        static_assert(std::is_same_v<std::remove_cv_t<std::invoke_result_t<F>>, Optional>,
+                      "F must return Optional<T>");
+        if (HasValue()) {
+            return *this;
+        }
+        return std::forward<F>(f)();
+    }
 
-    constexpr std::add_pointer_t<const value_type> operator->() const;
+    template <typename F>
+    constexpr Optional OrElse(F&& f) && {
+        static_assert(std::is_same_v<std::remove_cv_t<std::invoke_result_t<F>>, Optional>,
+                      "F must return Optional<T>");
+        if (HasValue()) {
+            return std::move(*this);
+        }
+        return std::forward<F>(f)();
+    }
 
-    constexpr std::add_pointer_t<value_type> operator->();
+    constexpr bool HasValue() const noexcept {
+        return this->Engaged();
+    }
 
-    constexpr const value_type& operator*() const&;
+    constexpr explicit operator bool() const noexcept {
+        return HasValue();
+    }
+
+    constexpr std::add_pointer_t<const value_type> operator->() const {
+        return std::addressof(this->Get());
+    }
+
+    constexpr std::add_pointer_t<value_type> operator->() {
+        return std::addressof(this->Get());
+    }
+
+    constexpr const value_type& operator*() const& {
+        return this->Get();
+    }
+
+    constexpr value_type& operator*() & {
+        return this->Get();
+    }
+
+    constexpr const value_type&& operator*() const&& {
+        return std::move(*this).Get();
+    }
+
+    constexpr value_type&& operator*() && {
+        return std::move(*this).Get();
+    }
+
+private:
+    template <typename U>
+    friend class Optional;
 
-    constexpr value_type& operator*() &;
+    template <typename F, typename Arg>
+    constexpr Optional(detail::InvokeTag, F&& f, Arg&& arg)
+        : Base(detail::InvokeTag(), std::forward<F>(f), std::forward<Arg>(arg)) {
+    }
 
-    constexpr const value_type&& operator*() const&&;
+    template <typename Self, typename F>
+    static constexpr auto AndThenImpl(Self&& self, F&& f) {
+        using Value = decltype(std::forward<Self>(self).Get());
+        using Result = std::remove_cv_t<std::remove_reference_t<std::invoke_result_t<F, Value>>>;
+        static_assert(detail::kIsOptional<Result>, "F must return an Optional");
+        if (self.HasValue()) {
+            return Result(std::invoke(std::forward<F>(f), std::forward<Self>(self).Get()));
+        }
+        return Result();
+    }
 
-    constexpr value_type&& operator*() &&;
+    template <typename Self, typename F>
+    static constexpr auto TransformImpl(Self&& self, F&& f) {
+        using Value = decltype(std::forward<Self>(self).Get());
+        using U = std::remove_cv_t<std::invoke_result_t<F, Value>>;
+        static_assert(std::is_object_v<U> && !std::is_array_v<U> &&
+                          !std::is_same_v<U, InPlace> && !std::is_same_v<U, NullOpt>,
+                      "F must return a value which Optional can hold");
+        if (self.HasValue()) {
+            return Optional<U>(detail::InvokeTag(), std::forward<F>(f),
+                               std::forward<Self>(self).Get());
+        }
+        return Optional<U>();
+    }
 };
-}  // namespace task
\ No newline at end of file
+}  // namespace task
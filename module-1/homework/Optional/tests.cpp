@@ -1,9 +1,100 @@
 #include <cstdint>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <utility>
 
 #include "gtest/gtest.h"
 #include "optional.h"
 
+enum class Color : uint8_t { kRed, kGreen, kBlue };
+
+template <>
+struct task::NicheTraits<Color> {
+    static constexpr Color Niche() noexcept {
+        return static_cast<Color>(0xff);
+    }
+    static constexpr bool IsNiche(Color value) noexcept {
+        return value == Niche();
+    }
+};
+
+// Counts its live copies, registers a niche with a nested niche_traits
+class Live {
+    struct NicheAccess;
+
+public:
+    using niche_traits = NicheAccess;
+
+    explicit Live(int32_t* alive) : alive_(alive) {
+        ++*alive_;
+    }
+    Live(const Live& other) : Live(other.alive_) {
+    }
+    Live& operator=(const Live&) = default;
+    ~Live() {
+        --*alive_;
+    }
+
+private:
+    struct NicheAccess {
+        static Live Niche() noexcept {
+            return Live();
+        }
+        static bool IsNiche(const Live& value) noexcept {
+            return value.alive_ == nullptr;
+        }
+    };
+
+    Live() = default;
+
+    int32_t* alive_ = nullptr;
+};
+
+// Owns a heap value, its niche owns nothing. A copy of a negative value
+// throws after the pointer is set
+class Fragile {
+    struct NicheAccess;
+
+public:
+    using niche_traits = NicheAccess;
+
+    explicit Fragile(int32_t value) : value_(new int32_t(value)) {
+    }
+    Fragile(const Fragile& other) : value_(new int32_t(*other.value_)) {
+        if (*value_ < 0) {
+            delete value_;
+            throw std::runtime_error("copy failed");
+        }
+    }
+    Fragile& operator=(const Fragile& other) {
+        Fragile copy(other);
+        std::swap(value_, copy.value_);
+        return *this;
+    }
+    ~Fragile() {
+        delete value_;
+    }
+
+    int32_t Value() const {
+        return *value_;
+    }
+
+private:
+    struct NicheAccess {
+        static Fragile Niche() noexcept {
+            return Fragile();
+        }
+        static bool IsNiche(const Fragile& value) noexcept {
+            return value.value_ == nullptr;
+        }
+    };
+
+    Fragile() = default;
+
+    int32_t* value_ = nullptr;
+};
+
 TEST(ValueOR, Test1) {
     task::Optional<std::string> opt("Hello world");
     ASSERT_EQ(opt.ValueOr("empty"), "Hello world");
@@ -40,6 +131,181 @@ TEST(IndirectionOperator, Test1) {
     ASSERT_EQ(*opt, 1);
 }
 
+// Copies and the destructor stay trivial when they are trivial for T
+TEST(Optional, Trivial) {
+    struct Pod {
+        int32_t x;
+        double y;
+    };
+    static_assert(std::is_trivially_copyable_v<task::Optional<int32_t>>);
+    static_assert(std::is_trivially_copyable_v<task::Optional<Pod>>);
+    static_assert(std::is_trivially_destructible_v<task::Optional<Pod>>);
+    static_assert(!std::is_trivially_copyable_v<task::Optional<std::string>>);
+    static_assert(!std::is_copy_constructible_v<task::Optional<std::unique_ptr<int>>>);
+    static_assert(std::is_move_constructible_v<task::Optional<std::unique_ptr<int>>>);
+    static_assert(sizeof(task::Optional<int32_t>) == 2 * sizeof(int32_t));
+
+    constexpr task::Optional<int32_t> kSeven(7);
+    constexpr task::Optional<int32_t> kEmpty;
+    static_assert(*kSeven == 7 && !kEmpty.HasValue() && kEmpty.ValueOr(1) == 1);
+    static constexpr int32_t kTarget = 3;
+    constexpr task::Optional<const int32_t*> kPtr(&kTarget);
+    constexpr task::Optional<int32_t*> kNoPtr;
+    static_assert(**kPtr == 3 && !kNoPtr.HasValue() && kNoPtr.ValueOr(nullptr) == nullptr);
+
+    task::Optional<Pod> pod(Pod{1, 2.0});
+    task::Optional<Pod> copy = pod;
+    pod = task::kNullOpt;
+    ASSERT_TRUE(!pod && copy && copy->x == 1);
+}
+
+TEST(Optional, CopyMove) {
+    task::Optional<std::string> opt("Hello world");
+    task::Optional<std::string> copy = opt;
+    task::Optional<std::string> moved = std::move(opt);
+    ASSERT_TRUE(*copy == "Hello world" && *moved == "Hello world");
+
+    task::Optional<std::string> empty;
+    copy = empty;
+    ASSERT_FALSE(copy.HasValue());
+    copy = std::move(moved);
+    ASSERT_EQ(std::move(copy).ValueOr("empty"), "Hello world");
+
+    task::Optional<std::unique_ptr<int32_t>> unique(task::kInPlace, new int32_t(1));
+    task::Optional<std::unique_ptr<int32_t>> owner = std::move(unique);
+    ASSERT_EQ(**owner, 1);
+}
+
+// Counts the copies and moves of the payload
+struct Tracked {
+    explicit Tracked(int32_t v) : value(v) {
+    }
+    Tracked(const Tracked& other) : value(other.value) {
+        ++copies;
+    }
+    Tracked(Tracked&& other) noexcept : value(other.value) {
+        ++moves;
+    }
+    Tracked& operator=(const Tracked&) = default;
+    Tracked& operator=(Tracked&&) = default;
+
+    static void ResetCounts() {
+        copies = 0;
+        moves = 0;
+    }
+
+    int32_t value;
+    static inline int32_t copies = 0;
+    static inline int32_t moves = 0;
+};
+
+TEST(Monadic, Test1) {
+    auto half = [](int32_t x) {
+        return x % 2 == 0 ? task::Optional<int32_t>(x / 2) : task::Optional<int32_t>();
+    };
+    task::Optional<int32_t> opt(12);
+    ASSERT_EQ(*opt.AndThen(half).AndThen(half), 3);
+    ASSERT_FALSE(opt.AndThen(half).AndThen(half).AndThen(half).HasValue());
+    ASSERT_EQ(*opt.Transform([](int32_t x) { return std::to_string(x); }), "12");
+    ASSERT_FALSE(task::Optional<int32_t>().Transform([](int32_t x) { return x + 1; }));
+
+    auto seven = [] { return task::Optional<int32_t>(7); };
+    ASSERT_EQ(*opt.OrElse(seven), 12);
+    ASSERT_EQ(*task::Optional<int32_t>().OrElse(seven), 7);
+
+    // The value is passed as the Optional is qualified
+    opt.Transform([](int32_t& x) { return x *= 2; });
+    ASSERT_EQ(*opt, 24);
+}
+
+// A chain on an rvalue hands the payload on without copies or moves
+TEST(Monadic, NoCopies) {
+    auto next = [](Tracked&& t) { return task::Optional<Tracked>(task::kInPlace, t.value + 1); };
+    auto value = [](const Tracked& t) { return t.value; };
+
+    Tracked::ResetCounts();
+    task::Optional<Tracked> opt(task::kInPlace, 1);
+    int32_t result = *std::move(opt)
+                          .AndThen(next)
+                          .Transform([](Tracked&& t) { return Tracked(t.value * 10); })
+                          .AndThen(next)
+                          .Transform(value);
+    ASSERT_EQ(result, 21);
+    ASSERT_TRUE(Tracked::copies == 0 && Tracked::moves == 0);
+
+    const task::Optional<Tracked> constant(task::kInPlace, 2);
+    ASSERT_EQ(*constant.Transform(value), 2);
+    ASSERT_EQ(*constant.AndThen([](const Tracked& t) { return task::Optional<int32_t>(t.value); }),
+              2);
+    ASSERT_TRUE(Tracked::copies == 0 && Tracked::moves == 0);
+
+    auto fallback = [] { return task::Optional<Tracked>(task::kInPlace, 3); };
+    ASSERT_EQ(task::Optional<Tracked>().OrElse(fallback)->value, 3);
+    ASSERT_TRUE(Tracked::copies == 0 && Tracked::moves == 0);
+
+    // The result is a new Optional: an rvalue moves into it, an lvalue copies
+    ASSERT_EQ(std::move(opt).OrElse(fallback)->value, 1);
+    ASSERT_TRUE(Tracked::copies == 0 && Tracked::moves == 1);
+    ASSERT_EQ(constant.OrElse(fallback)->value, 2);
+    ASSERT_TRUE(Tracked::copies == 1 && Tracked::moves == 1);
+}
+
+// Types with a niche keep the empty state in the value itself
+TEST(Optional, Niche) {
+    static_assert(sizeof(task::Optional<Color>) == sizeof(Color));
+    static_assert(sizeof(task::Optional<Live>) == sizeof(Live));
+    static_assert(sizeof(task::Optional<int64_t>) == 2 * sizeof(int64_t));
+    static_assert(std::is_trivially_copyable_v<task::Optional<Color>>);
+
+    constexpr task::Optional<Color> kBlue(Color::kBlue);
+    static_assert(kBlue.HasValue() && task::Optional<Color>().ValueOr(Color::kRed) == Color::kRed);
+
+    // Raw pointers have no niche: null is a value, and the flag keeps them constexpr
+    constexpr task::Optional<int32_t*> kNull(nullptr);
+    constexpr task::Optional<int32_t*> kNone;
+    static_assert(kNull.HasValue() && *kNull == nullptr && !kNone.HasValue());
+    static_assert(std::is_trivially_copyable_v<task::Optional<int32_t*>>);
+
+    int32_t x = 1;
+    task::Optional<int32_t*> ptr(&x);
+    task::Optional<int32_t*> null(nullptr);
+    task::Optional<int32_t*> empty;
+    ASSERT_TRUE(ptr && **ptr == 1 && null && *null == nullptr && !empty);
+    ptr = task::kNullOpt;
+    ASSERT_FALSE(ptr.HasValue());
+
+    int32_t alive = 0;
+    {
+        task::Optional<Live> live(task::kInPlace, &alive);
+        task::Optional<Live> copy = live;
+        task::Optional<Live> none;
+        ASSERT_TRUE(live && copy && !none && alive == 2);
+        copy = none;
+        ASSERT_TRUE(!copy && alive == 1);
+        none = live;
+        ASSERT_TRUE(none && alive == 2);
+        live.Reset();
+        ASSERT_EQ(alive, 1);
+    }
+    ASSERT_EQ(alive, 0);
+}
+
+// A throwing constructor leaves the niche in place, so the Optional stays empty
+TEST(Optional, NicheThrowingConstructor) {
+    static_assert(sizeof(task::Optional<Fragile>) == sizeof(Fragile));
+    Fragile bad(-1);
+    task::Optional<Fragile> opt;
+    ASSERT_THROW(opt = bad, std::runtime_error);
+    ASSERT_FALSE(opt.HasValue());
+
+    task::Optional<Fragile> holder(task::kInPlace, -2);
+    ASSERT_THROW(opt = holder, std::runtime_error);
+    ASSERT_FALSE(opt.HasValue());
+
+    opt = Fragile(3);
+    ASSERT_TRUE(opt && opt->Value() == 3);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
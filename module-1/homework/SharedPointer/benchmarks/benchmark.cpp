@@ -0,0 +1,456 @@
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../../Allocator/src/allocator/allocator.h"
+#include "../src/shared_ptr/atomic_shared_ptr.h"
+#include "../src/shared_ptr/intrusive_ptr.h"
+#include "../src/shared_ptr/shared_ptr.h"
+#include "benchmark/benchmark.h"
+
+// Adapters over the two implementations, every benchmark runs once for each
+template <LockPolicy Policy>
+struct Task {
+    template <typename T>
+    using Shared = SharedPtr<T, Policy>;
+    template <typename T>
+    using Weak = WeakPtr<T, Policy>;
+
+    template <typename T, typename... Args>
+    static Shared<T> Make(Args&&... args) {
+        return MakeShared<T, Policy>(std::forward<Args>(args)...);
+    }
+    template <typename T, typename Allocator, typename... Args>
+    static Shared<T> Allocate(const Allocator& alloc, Args&&... args) {
+        return AllocateShared<T, Policy>(alloc, std::forward<Args>(args)...);
+    }
+    template <typename T>
+    static Shared<T> Lock(const Weak<T>& weak) {
+        return weak.Lock();
+    }
+};
+
+using Atomic = Task<LockPolicy::kAtomic>;
+using Single = Task<LockPolicy::kSingle>;
+using Biased = Task<LockPolicy::kBiased>;
+using Epoch = Task<LockPolicy::kEpoch>;
+
+struct Std {
+    template <typename T>
+    using Shared = std::shared_ptr<T>;
+    template <typename T>
+    using Weak = std::weak_ptr<T>;
+
+    template <typename T, typename... Args>
+    static Shared<T> Make(Args&&... args) {
+        return std::make_shared<T>(std::forward<Args>(args)...);
+    }
+    template <typename T, typename Allocator, typename... Args>
+    static Shared<T> Allocate(const Allocator& alloc, Args&&... args) {
+        return std::allocate_shared<T>(alloc, std::forward<Args>(args)...);
+    }
+    template <typename T>
+    static Shared<T> Lock(const Weak<T>& weak) {
+        return weak.lock();
+    }
+};
+
+// The cases of perfomance() from seminar17/grim.cpp: one short-lived int per
+// iteration, owned in different ways
+void RawNew(benchmark::State& state) {
+    int64_t i = 0;
+    for (auto _ : state) {
+        auto tmp = new int64_t(i++);
+        benchmark::DoNotOptimize(tmp);
+        delete tmp;
+    }
+}
+
+void UniqueFromPointer(benchmark::State& state) {
+    int64_t i = 0;
+    for (auto _ : state) {
+        std::unique_ptr<int64_t> tmp(new int64_t(i++));
+        benchmark::DoNotOptimize(tmp.get());
+    }
+}
+
+void MakeUnique(benchmark::State& state) {
+    int64_t i = 0;
+    for (auto _ : state) {
+        auto tmp = std::make_unique<int64_t>(i++);
+        benchmark::DoNotOptimize(tmp.get());
+    }
+}
+
+template <typename Impl>
+void FromPointer(benchmark::State& state) {
+    int64_t i = 0;
+    for (auto _ : state) {
+        typename Impl::template Shared<int64_t> tmp(new int64_t(i++));
+        benchmark::DoNotOptimize(*tmp);
+    }
+}
+
+template <typename Impl>
+void Make(benchmark::State& state) {
+    int64_t i = 0;
+    for (auto _ : state) {
+        auto tmp = Impl::template Make<int64_t>(i++);
+        benchmark::DoNotOptimize(*tmp);
+    }
+}
+
+// MakeShared with the block taken from the pool allocator
+template <typename Impl>
+void AllocateFromPool(benchmark::State& state) {
+    int64_t i = 0;
+    for (auto _ : state) {
+        auto tmp = Impl::template Allocate<int64_t>(CustomAllocator<int64_t>(), i++);
+        benchmark::DoNotOptimize(*tmp);
+    }
+}
+
+// Same with a non-trivial object, constructed in place
+template <typename Impl>
+void MakeString(benchmark::State& state) {
+    for (auto _ : state) {
+        auto tmp = Impl::template Make<std::string>("hello");
+        benchmark::DoNotOptimize(*tmp);
+    }
+}
+
+template <typename Impl>
+void Copy(benchmark::State& state) {
+    auto ptr = Impl::template Make<int64_t>(42);
+    for (auto _ : state) {
+        auto copy = ptr;
+        benchmark::DoNotOptimize(*copy);
+    }
+}
+
+template <typename Impl>
+void Assign(benchmark::State& state) {
+    auto first = Impl::template Make<int64_t>(1);
+    auto second = Impl::template Make<int64_t>(2);
+    auto ptr = first;
+    for (auto _ : state) {
+        ptr = second;
+        ptr = first;
+        benchmark::DoNotOptimize(*ptr);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+// Dropping range(0) copies of one pointer, the last one frees the object
+template <typename Impl>
+void Destroy(benchmark::State& state) {
+    std::vector<typename Impl::template Shared<int64_t>> copies;
+    copies.reserve(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        copies.assign(static_cast<std::size_t>(state.range(0)),
+                      Impl::template Make<int64_t>(42));
+        state.ResumeTiming();
+        copies.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Impl>
+void Lock(benchmark::State& state) {
+    auto ptr = Impl::template Make<int64_t>(42);
+    typename Impl::template Weak<int64_t> weak(ptr);
+    for (auto _ : state) {
+        auto locked = Impl::Lock(weak);
+        benchmark::DoNotOptimize(*locked);
+    }
+}
+
+// Every thread copies the same pointer, so the reference counter is contended.
+// The first thread creates the object: a biased block counts its copies
+// without touching the shared cache line
+template <typename Impl>
+void SharedCopy(benchmark::State& state) {
+    using Shared = typename Impl::template Shared<int64_t>;
+    static Shared* ptr = nullptr;
+    if (state.thread_index() == 0) {
+        ptr = new Shared(Impl::template Make<int64_t>(42));
+    }
+    for (auto _ : state) {
+        Shared copy = *ptr;
+        benchmark::DoNotOptimize(*copy);
+    }
+    if (state.thread_index() == 0) {
+        delete ptr;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// A cache of WeakPtr shared by all threads: every lookup locks one of 1024
+// entries and reads the object. The first thread builds the cache
+template <typename Impl>
+struct LookupCache {
+    explicit LookupCache(std::size_t size) {
+        for (std::size_t i = 0; i < size; i++) {
+            owners.push_back(Impl::template Make<int64_t>(static_cast<int64_t>(i)));
+            entries.emplace_back(owners.back());
+        }
+    }
+
+    std::vector<typename Impl::template Shared<int64_t>> owners;
+    std::vector<typename Impl::template Weak<int64_t>> entries;
+};
+
+template <typename Impl>
+void CacheLookup(benchmark::State& state) {
+    static LookupCache<Impl>* cache = nullptr;
+    if (state.thread_index() == 0) {
+        cache = new LookupCache<Impl>(1024);
+    }
+    std::size_t i = static_cast<std::size_t>(state.thread_index()) * 64;
+    for (auto _ : state) {
+        auto locked = Impl::Lock(cache->entries[i++ % cache->entries.size()]);
+        benchmark::DoNotOptimize(*locked);
+    }
+    if (state.thread_index() == 0) {
+        delete cache;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Same lookups without touching the counters: epoch blocks only
+void CacheBorrow(benchmark::State& state) {
+    static LookupCache<Epoch>* cache = nullptr;
+    if (state.thread_index() == 0) {
+        cache = new LookupCache<Epoch>(1024);
+    }
+    std::size_t i = static_cast<std::size_t>(state.thread_index()) * 64;
+    for (auto _ : state) {
+        EpochGuard guard;
+        int64_t* borrowed = cache->entries[i++ % cache->entries.size()].Borrow(guard);
+        benchmark::DoNotOptimize(*borrowed);
+    }
+    if (state.thread_index() == 0) {
+        delete cache;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Small objects owned with the counter inside them against a fused control
+// block, the heap bytes per object and the pointer size go to the counters
+struct IntrusiveValue : IntrusiveRefCounted<IntrusiveValue> {
+    explicit IntrusiveValue(int64_t value) : value(value) {
+    }
+    int64_t value;
+};
+
+struct PooledValue : IntrusiveRefCounted<PooledValue, LockPolicy::kAtomic,
+                                         AllocatorDelete<CustomAllocator<PooledValue>>> {
+    explicit PooledValue(int64_t value) : value(value) {
+    }
+    int64_t value;
+};
+
+struct IntrusiveOwner {
+    using Ptr = IntrusivePtr<IntrusiveValue>;
+    static constexpr std::size_t kObjectBytes = sizeof(IntrusiveValue);
+
+    static Ptr Make(int64_t value) {
+        return MakeIntrusive<IntrusiveValue>(value);
+    }
+    static IntrusivePtr<PooledValue> Allocate(int64_t value) {
+        return AllocateIntrusive<PooledValue>(CustomAllocator<PooledValue>(), value);
+    }
+    static int64_t Value(const Ptr& ptr) {
+        return ptr->value;
+    }
+};
+
+struct SharedOwner {
+    using Ptr = SharedPtr<int64_t>;
+    static constexpr std::size_t kObjectBytes =
+        sizeof(InplaceControlBlock<int64_t, std::allocator<int64_t>, LockPolicy::kAtomic>);
+
+    static Ptr Make(int64_t value) {
+        return MakeShared<int64_t>(value);
+    }
+    static Ptr Allocate(int64_t value) {
+        return AllocateShared<int64_t>(CustomAllocator<int64_t>(), value);
+    }
+    static int64_t Value(const Ptr& ptr) {
+        return *ptr;
+    }
+};
+
+template <typename Owner>
+void SetFootprint(benchmark::State& state) {
+    state.counters["object_bytes"] = static_cast<double>(Owner::kObjectBytes);
+    state.counters["pointer_bytes"] = static_cast<double>(sizeof(typename Owner::Ptr));
+}
+
+template <typename Owner>
+void SmallMake(benchmark::State& state) {
+    int64_t i = 0;
+    for (auto _ : state) {
+        auto tmp = Owner::Make(i++);
+        benchmark::DoNotOptimize(Owner::Value(tmp));
+    }
+    SetFootprint<Owner>(state);
+}
+
+template <typename Owner>
+void SmallCopy(benchmark::State& state) {
+    auto ptr = Owner::Make(42);
+    for (auto _ : state) {
+        auto copy = ptr;
+        benchmark::DoNotOptimize(Owner::Value(copy));
+    }
+    SetFootprint<Owner>(state);
+}
+
+// Both are freed back to the pool allocator
+template <typename Owner>
+void SmallFromPool(benchmark::State& state) {
+    int64_t i = 0;
+    for (auto _ : state) {
+        auto tmp = Owner::Allocate(i++);
+        benchmark::DoNotOptimize(tmp.Get());
+    }
+}
+
+// Pointers to many objects: the bigger SharedPtr and block spread them over
+// more cache lines
+template <typename Owner>
+void SmallTraverse(benchmark::State& state) {
+    std::vector<typename Owner::Ptr> ptrs;
+    for (int64_t i = 0; i < state.range(0); i++) {
+        ptrs.push_back(Owner::Make(i));
+    }
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (const auto& ptr : ptrs) {
+            sum += Owner::Value(ptr);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    SetFootprint<Owner>(state);
+}
+
+// Snapshot holders for Publish: lock-free one against a mutex around the pointer
+class LockedSnapshot {
+public:
+    SharedPtr<int64_t> Load() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return ptr_;
+    }
+    void Store(SharedPtr<int64_t> desired) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ptr_.Swap(desired);
+    }
+
+private:
+    mutable std::mutex mutex_;
+    SharedPtr<int64_t> ptr_;
+};
+
+using AtomicSnapshot = AtomicSharedPtr<int64_t>;
+
+// Readers load the current snapshot while thread 0 also publishes a new one
+// every 64 iterations
+template <typename Holder>
+void Publish(benchmark::State& state) {
+    static Holder* holder = nullptr;
+    if (state.thread_index() == 0) {
+        holder = new Holder();
+        holder->Store(MakeShared<int64_t>(0));
+    }
+    int64_t version = 0;
+    for (auto _ : state) {
+        if (state.thread_index() == 0 && ++version % 64 == 0) {
+            holder->Store(MakeShared<int64_t>(version));
+        }
+        SharedPtr<int64_t> snapshot = holder->Load();
+        benchmark::DoNotOptimize(*snapshot);
+    }
+    if (state.thread_index() == 0) {
+        delete holder;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Pointers to many separate objects: the cost of the allocations and of
+// chasing the control block when dereferencing
+template <typename Impl>
+void Traverse(benchmark::State& state) {
+    std::vector<typename Impl::template Shared<int64_t>> ptrs;
+    for (int64_t i = 0; i < state.range(0); i++) {
+        ptrs.push_back(Impl::template Make<int64_t>(i));
+    }
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (const auto& ptr : ptrs) {
+            sum += *ptr;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(RawNew);
+BENCHMARK(UniqueFromPointer);
+BENCHMARK(MakeUnique);
+BENCHMARK_TEMPLATE(FromPointer, Atomic);
+BENCHMARK_TEMPLATE(FromPointer, Single);
+BENCHMARK_TEMPLATE(FromPointer, Std);
+BENCHMARK_TEMPLATE(Make, Atomic);
+BENCHMARK_TEMPLATE(Make, Single);
+BENCHMARK_TEMPLATE(Make, Biased);
+BENCHMARK_TEMPLATE(Make, Std);
+BENCHMARK_TEMPLATE(AllocateFromPool, Atomic);
+BENCHMARK_TEMPLATE(AllocateFromPool, Std);
+BENCHMARK_TEMPLATE(MakeString, Atomic);
+BENCHMARK_TEMPLATE(MakeString, Std);
+
+BENCHMARK_TEMPLATE(Copy, Atomic);
+BENCHMARK_TEMPLATE(Copy, Single);
+BENCHMARK_TEMPLATE(Copy, Biased);
+BENCHMARK_TEMPLATE(Copy, Std);
+BENCHMARK_TEMPLATE(Assign, Atomic);
+BENCHMARK_TEMPLATE(Assign, Single);
+BENCHMARK_TEMPLATE(Assign, Biased);
+BENCHMARK_TEMPLATE(Assign, Std);
+BENCHMARK_TEMPLATE(Destroy, Atomic)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(Destroy, Single)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(Destroy, Biased)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(Destroy, Std)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(Lock, Atomic);
+BENCHMARK_TEMPLATE(Lock, Single);
+BENCHMARK_TEMPLATE(Lock, Epoch);
+BENCHMARK_TEMPLATE(Lock, Std);
+
+BENCHMARK_TEMPLATE(SharedCopy, Atomic)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(SharedCopy, Biased)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(SharedCopy, Std)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(CacheLookup, Atomic)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(CacheLookup, Epoch)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(CacheLookup, Std)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(CacheBorrow)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_TEMPLATE(SmallMake, IntrusiveOwner);
+BENCHMARK_TEMPLATE(SmallMake, SharedOwner);
+BENCHMARK_TEMPLATE(SmallFromPool, IntrusiveOwner);
+BENCHMARK_TEMPLATE(SmallFromPool, SharedOwner);
+BENCHMARK_TEMPLATE(SmallCopy, IntrusiveOwner);
+BENCHMARK_TEMPLATE(SmallCopy, SharedOwner);
+BENCHMARK_TEMPLATE(SmallTraverse, IntrusiveOwner)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(SmallTraverse, SharedOwner)->Range(1 << 10, 1 << 18);
+
+BENCHMARK_TEMPLATE(Publish, AtomicSnapshot)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(Publish, LockedSnapshot)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(Traverse, Atomic)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(Traverse, Std)->Range(1 << 10, 1 << 18);
+
+BENCHMARK_MAIN();
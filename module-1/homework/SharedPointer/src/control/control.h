@@ -1,28 +1,618 @@
 #pragma once
 
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
 
+#include "epoch.h"
+
+// How the reference counters are updated
+enum class LockPolicy {
+    kAtomic,  // owners of one object may live on different threads
+    kSingle,  // all owners of an object stay on one thread: plain increments
+    kBiased,  // owners mostly stay on the thread which created the object
+    kEpoch,   // like kAtomic, the object is destroyed later by EpochDomain
+};
+
+// Keeps the shared counter of biased blocks away from the fields of the owner
+constexpr std::size_t kCacheLineSize = 64;
+
+template <LockPolicy Policy>
+class RefCount;
+
+template <>
+class RefCount<LockPolicy::kAtomic> {
+public:
+    explicit RefCount(std::size_t value) noexcept : value_(value) {
+    }
+
+    void Increment() noexcept {
+        value_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Returns the value before the decrement
+    std::size_t Decrement() noexcept {
+        return value_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    // Fails once the value has dropped to zero
+    bool IncrementIfNotZero() noexcept {
+        std::size_t value = value_.load(std::memory_order_relaxed);
+        while (value != 0) {
+            if (value_.compare_exchange_weak(value, value + 1, std::memory_order_acq_rel,
+                                             std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::size_t Load() const noexcept {
+        return value_.load(std::memory_order_acquire);
+    }
+
+    // Only while no other thread can see the counter
+    void Store(std::size_t value) noexcept {
+        value_.store(value, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<std::size_t> value_;
+};
+
+template <>
+class RefCount<LockPolicy::kSingle> {
+public:
+    explicit RefCount(std::size_t value) noexcept : value_(value) {
+    }
+
+    void Increment() noexcept {
+        ++value_;
+    }
+
+    std::size_t Decrement() noexcept {
+        return value_--;
+    }
+
+    bool IncrementIfNotZero() noexcept {
+        if (value_ == 0) {
+            return false;
+        }
+        ++value_;
+        return true;
+    }
+
+    std::size_t Load() const noexcept {
+        return value_;
+    }
+
+    void Store(std::size_t value) noexcept {
+        value_ = value;
+    }
+
+private:
+    std::size_t value_;
+};
+
+// Number of SharedPtr owners. The object is destroyed by OnZeroShared once
+// the last of them is gone
+template <LockPolicy Policy = LockPolicy::kAtomic>
 class SharedCount {
 public:
-    // Your code goes here...
+    explicit SharedCount(std::size_t shared_owners = 1) noexcept : shared_owners_(shared_owners) {
+    }
+
+    SharedCount(const SharedCount&) = delete;
+    SharedCount& operator=(const SharedCount&) = delete;
+
+    virtual ~SharedCount() = default;
+
+    void AddShared() noexcept {
+        shared_owners_.Increment();
+    }
+
+    // Fails once the object is gone
+    bool TryAddShared() noexcept {
+        return shared_owners_.IncrementIfNotZero();
+    }
+
+    // Returns true if this call destroyed the object
+    bool ReleaseShared() noexcept {
+        if (shared_owners_.Decrement() == 1) {
+            OnZeroShared();
+            return true;
+        }
+        return false;
+    }
+
+    std::size_t UseCount() const noexcept {
+        return shared_owners_.Load();
+    }
+
+protected:
+    virtual void OnZeroShared() noexcept = 0;
+
+    RefCount<Policy> shared_owners_;
+};
+
+template <>
+class SharedCount<LockPolicy::kBiased>;
+
+template <>
+class SharedCount<LockPolicy::kEpoch>;
+
+// Per-thread state of biased reference counting: the queue of blocks owned by
+// the thread whose shared counter went negative and must be merged by it
+class BiasedThread {
+    using Block = SharedCount<LockPolicy::kBiased>;
+
+public:
+    // The record of the calling thread, nullptr if it owns no block yet
+    static BiasedThread* Current() noexcept {
+        return current_;
+    }
+
+    // Makes the calling thread able to own blocks. Returns nullptr once the
+    // thread is exiting or out of memory, its blocks are never biased then
+    static BiasedThread* Attach() noexcept;
+
+    // Blocks keep the record of their owner alive. The owner counts the
+    // blocks it creates and destroys itself without atomics and folds the
+    // balance into refs_ on exit. Until then refs_ carries kLive, so blocks
+    // destroyed by other threads cannot bring it to zero
+    void AddBlock() noexcept {
+        ++own_blocks_;
+    }
+
+    void RemoveBlock() noexcept {
+        if (this == current_) {
+            --own_blocks_;
+        } else if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    // Called by other threads. Returns false if the owner has exited, the
+    // caller merges the block itself then
+    bool Push(Block* block) noexcept;
+
+    // Merges the queued blocks, only called by the owner
+    void Drain() noexcept {
+        if (head_.load(std::memory_order_relaxed) != 0) {
+            Merge(head_.exchange(0, std::memory_order_acquire));
+        }
+    }
+
+private:
+    static constexpr std::uintptr_t kClosed = 1;
+    static constexpr std::int64_t kLive = std::int64_t{1} << 62;
+
+    struct Holder {
+        ~Holder() {
+            if (thread != nullptr) {
+                thread->Close();
+            }
+        }
+
+        BiasedThread* thread = nullptr;
+    };
+
+    BiasedThread() = default;
+
+    // The owner is exiting: merges what is queued and makes later pushes fail
+    void Close() noexcept {
+        current_ = nullptr;
+        exited_ = true;
+        Merge(head_.exchange(kClosed, std::memory_order_acq_rel));
+        std::int64_t fold = own_blocks_ - kLive;
+        if (refs_.fetch_add(fold, std::memory_order_acq_rel) + fold == 0) {
+            delete this;
+        }
+    }
+
+    static void Merge(std::uintptr_t head) noexcept;
+
+    std::atomic<std::uintptr_t> head_{0};
+    std::atomic<std::int64_t> refs_{kLive};
+    std::int64_t own_blocks_ = 0;
+
+    static inline thread_local BiasedThread* current_ = nullptr;
+    static inline thread_local bool exited_ = false;
+    static thread_local Holder holder_;
+};
+
+inline thread_local BiasedThread::Holder BiasedThread::holder_;
+
+// Biased reference counting (Choi, Shull, Torrellas). The thread which
+// created the object owns the block and counts its own references with plain
+// loads and stores, every other thread uses the atomic shared counter on a
+// cache line of its own. The shared counter may go negative while a reference
+// taken by the owner is dropped elsewhere: the block is then queued to the
+// owner, which merges both counters on its next MakeShared or on exit.
+// Once merged the block behaves like an atomic one.
+template <>
+class SharedCount<LockPolicy::kBiased> {
+public:
+    explicit SharedCount(std::size_t shared_owners = 1) noexcept
+        : home_(BiasedThread::Attach()), owner_merged_(home_ == nullptr) {
+        if (home_ == nullptr) {
+            shared_.store(Pack(shared_owners) | kMerged, std::memory_order_relaxed);
+        } else {
+            biased_.store(shared_owners, std::memory_order_relaxed);
+            home_->Drain();
+        }
+    }
+
+    SharedCount(const SharedCount&) = delete;
+    SharedCount& operator=(const SharedCount&) = delete;
+
+    virtual ~SharedCount() {
+        if (home_ != nullptr) {
+            home_->RemoveBlock();
+        }
+    }
+
+    void AddShared() noexcept {
+        if (IsOwner()) {
+            biased_.store(biased_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        } else {
+            shared_.fetch_add(kOne, std::memory_order_relaxed);
+        }
+    }
+
+    bool TryAddShared() noexcept {
+        if (IsOwner()) {
+            // The owner merges as soon as its count drops to zero, so the
+            // object is alive while the block is still biased
+            AddShared();
+            return true;
+        }
+        std::int64_t word = shared_.load(std::memory_order_relaxed);
+        do {
+            if ((word & kMerged) != 0 && Count(word) == 0) {
+                return false;
+            }
+        } while (!shared_.compare_exchange_weak(word, word + kOne, std::memory_order_acq_rel,
+                                                std::memory_order_relaxed));
+        return true;
+    }
+
+    bool ReleaseShared() noexcept {
+        if (IsOwner()) {
+            std::size_t biased = biased_.load(std::memory_order_relaxed) - 1;
+            biased_.store(biased, std::memory_order_relaxed);
+            if (biased != 0) {
+                return false;
+            }
+            owner_merged_ = true;
+            std::int64_t word = MergeBiased();
+            // A queued block is finished by the merge of the queue
+            if (Count(word) != 0 || (word & kQueued) != 0) {
+                return false;
+            }
+        } else if (!ReleaseSharedSlow()) {
+            return false;
+        }
+        OnZeroShared();
+        return true;
+    }
+
+    std::size_t UseCount() const noexcept {
+        // The shared counter goes first: a reference the owner counted and
+        // another thread dropped is seen on both sides or on neither. A merge
+        // in between moves the biased count, the snapshot is retried then
+        std::int64_t word = shared_.load(std::memory_order_acquire);
+        std::int64_t count = Count(word);
+        while ((word & kMerged) == 0) {
+            std::size_t biased = biased_.load(std::memory_order_acquire);
+            std::int64_t current = shared_.load(std::memory_order_acquire);
+            if ((current & kMerged) == 0) {
+                count += static_cast<std::int64_t>(biased);
+                break;
+            }
+            word = current;
+            count = Count(word);
+        }
+        return count > 0 ? static_cast<std::size_t>(count) : 0;
+    }
+
+    friend class BiasedThread;
+
+protected:
+    virtual void OnZeroShared() noexcept = 0;
+
+    // Destroys the object and drops the weak reference of the owners when
+    // the count reaches zero during the merge of a queued block
+    virtual void OnDeferredZero() noexcept = 0;
+
+private:
+    static constexpr std::int64_t kMerged = 1;
+    static constexpr std::int64_t kQueued = 2;
+    static constexpr std::int64_t kOne = 4;
+
+    static std::int64_t Pack(std::size_t count) noexcept {
+        return static_cast<std::int64_t>(count) * kOne;
+    }
+
+    static std::int64_t Count(std::int64_t word) noexcept {
+        return (word - (word & (kOne - 1))) / kOne;
+    }
+
+    bool IsOwner() const noexcept {
+        return home_ == BiasedThread::Current() && !owner_merged_;
+    }
+
+    // Returns true if the count dropped to zero
+    bool ReleaseSharedSlow() noexcept {
+        std::int64_t word = shared_.load(std::memory_order_relaxed);
+        std::int64_t desired = 0;
+        do {
+            desired = word - kOne;
+            if ((word & (kMerged | kQueued)) == 0 && Count(desired) < 0) {
+                desired |= kQueued;
+            }
+        } while (!shared_.compare_exchange_weak(word, desired, std::memory_order_acq_rel,
+                                                std::memory_order_relaxed));
+        if ((desired & kQueued) != 0 && (word & kQueued) == 0) {
+            if (!home_->Push(this)) {
+                MergeQueued();
+            }
+            return false;
+        }
+        return (desired & (kMerged | kQueued)) == kMerged && Count(desired) == 0;
+    }
+
+    // Moves the biased references to the shared counter, returns the new word
+    std::int64_t MergeBiased() noexcept {
+        std::int64_t add = Pack(biased_.exchange(0, std::memory_order_relaxed)) + kMerged;
+        return shared_.fetch_add(add, std::memory_order_acq_rel) + add;
+    }
+
+    // Merge of a block taken from the queue
+    void MergeQueued() noexcept {
+        if ((shared_.load(std::memory_order_acquire) & kMerged) == 0) {
+            owner_merged_ = true;
+            MergeBiased();
+        }
+        std::int64_t word = shared_.fetch_and(~kQueued, std::memory_order_acq_rel);
+        if (Count(word) == 0) {
+            OnDeferredZero();
+        }
+    }
+
+    // Written by the owner only
+    BiasedThread* const home_;
+    bool owner_merged_;
+    std::atomic<std::size_t> biased_{0};
+
+    // Written by other threads. The padding keeps the shared counter off the
+    // cache lines of the owner fields and of the object without over-aligning
+    // the block
+    [[maybe_unused]] unsigned char owner_padding_[kCacheLineSize];
+    std::atomic<std::int64_t> shared_{0};
+    SharedCount* queued_next_ = nullptr;
+    [[maybe_unused]] unsigned char shared_padding_[kCacheLineSize];
+};
+
+inline BiasedThread* BiasedThread::Attach() noexcept {
+    if (current_ == nullptr && !exited_) {
+        current_ = new (std::nothrow) BiasedThread;
+        holder_.thread = current_;
+    }
+    if (current_ != nullptr) {
+        current_->AddBlock();
+    }
+    return current_;
+}
+
+inline bool BiasedThread::Push(Block* block) noexcept {
+    std::uintptr_t head = head_.load(std::memory_order_relaxed);
+    do {
+        if (head == kClosed) {
+            return false;
+        }
+        block->queued_next_ = reinterpret_cast<Block*>(head);
+    } while (!head_.compare_exchange_weak(head, reinterpret_cast<std::uintptr_t>(block),
+                                          std::memory_order_release, std::memory_order_relaxed));
+    return true;
+}
+
+inline void BiasedThread::Merge(std::uintptr_t head) noexcept {
+    auto block = reinterpret_cast<Block*>(head);
+    while (block != nullptr) {
+        Block* next = block->queued_next_;
+        block->MergeQueued();
+        block = next;
+    }
+}
+
+// Sticky counter (Anderson, Blelloch, Wei): once it has dropped to zero it
+// stays there, so WeakPtr::Lock is a single fetch_add instead of a CAS loop.
+// The object is not destroyed at zero but retired to EpochDomain, a reader
+// inside an EpochGuard may keep using it after a successful UseCount check
+template <>
+class SharedCount<LockPolicy::kEpoch> : public EpochRetired {
+public:
+    explicit SharedCount(std::size_t shared_owners = 1) noexcept : shared_owners_(shared_owners) {
+    }
+
+    SharedCount(const SharedCount&) = delete;
+    SharedCount& operator=(const SharedCount&) = delete;
+
+    void AddShared() noexcept {
+        shared_owners_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // A late increment of a dead counter only changes bits nobody reads
+    bool TryAddShared() noexcept {
+        return (shared_owners_.fetch_add(1, std::memory_order_acquire) & kZero) == 0;
+    }
+
+    // Never destroys the object immediately, so always returns false
+    bool ReleaseShared() noexcept {
+        if (shared_owners_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::uint64_t expected = 0;
+            // A concurrent UseCount may have seen the zero first and marked it
+            // kHelped: then the exchange decides who retires the block
+            if (shared_owners_.compare_exchange_strong(expected, kZero) ||
+                ((expected & kHelped) != 0 && (shared_owners_.exchange(kZero) & kHelped) != 0)) {
+                EpochDomain::Retire(this);
+            }
+        }
+        return false;
+    }
+
+    // Sequentially consistent with the epoch: if a pinned reader sees a
+    // positive count, the block is retired in its epoch or a later one
+    std::size_t UseCount() const noexcept {
+        std::uint64_t value = shared_owners_.load();
+        if (value == 0 && shared_owners_.compare_exchange_strong(value, kZero | kHelped)) {
+            return 0;
+        }
+        return (value & kZero) != 0 ? 0 : static_cast<std::size_t>(value);
+    }
 
 protected:
-    // Your code goes here...
+    virtual void OnZeroShared() noexcept = 0;
+
+    // Destroys the object and drops the weak reference of the owners
+    virtual void OnDeferredZero() noexcept = 0;
+
+private:
+    static constexpr std::uint64_t kZero = std::uint64_t{1} << 63;
+    static constexpr std::uint64_t kHelped = std::uint64_t{1} << 62;
+
+    void Reclaim() noexcept final {
+        OnDeferredZero();
+    }
+
+    mutable std::atomic<std::uint64_t> shared_owners_;
 };
 
-class SharedWeakCount : public SharedCount {
+// Adds the number of WeakPtr owners. All the SharedPtr owners together hold
+// one weak reference, so the block itself is released by OnZeroWeak after
+// both the object and the last WeakPtr are gone
+template <LockPolicy Policy = LockPolicy::kAtomic>
+class SharedWeakCount : public SharedCount<Policy> {
+    // WeakPtr are rare next to SharedPtr copies, biased blocks count them atomically
+    static constexpr LockPolicy kWeakPolicy =
+        Policy == LockPolicy::kSingle ? LockPolicy::kSingle : LockPolicy::kAtomic;
+
 public:
-    // Your code goes here...
+    explicit SharedWeakCount(std::size_t shared_owners = 1) noexcept
+        : SharedCount<Policy>(shared_owners), shared_weak_owners_(1) {
+    }
+
+    void AddWeak() noexcept {
+        shared_weak_owners_.Increment();
+    }
+
+    void ReleaseWeak() noexcept {
+        // Only the last reference sees 1: with the object gone no new WeakPtr
+        // can appear, so the block is freed without a read-modify-write
+        if (shared_weak_owners_.Load() == 1 || shared_weak_owners_.Decrement() == 1) {
+            OnZeroWeak();
+        }
+    }
+
+    // Releases a shared reference
+    void Release() noexcept {
+        if (this->ReleaseShared()) {
+            ReleaseWeak();
+        }
+    }
+
+    // Takes a shared reference for WeakPtr::Lock, fails once the object is gone
+    bool Lock() noexcept {
+        return this->TryAddShared();
+    }
 
 protected:
-    // Your code goes here...
+    virtual void OnZeroWeak() noexcept = 0;
+
+    // Overrides the hook of SharedCount<LockPolicy::kBiased> and of
+    // SharedCount<LockPolicy::kEpoch>, unused otherwise
+    void OnDeferredZero() noexcept {
+        this->OnZeroShared();
+        ReleaseWeak();
+    }
+
+    RefCount<kWeakPolicy> shared_weak_owners_;
 };
 
-template <typename T, typename Deleter>
-class ControlBlock : public SharedWeakCount {
+// Block of SharedPtr(p, deleter): the object lives in an allocation of its own
+template <typename T, typename Deleter, LockPolicy Policy = LockPolicy::kAtomic>
+class ControlBlock : public SharedWeakCount<Policy> {
 public:
-    // Your code goes here...
+    ControlBlock(T* ptr, Deleter deleter) noexcept : ptr_(ptr), deleter_(std::move(deleter)) {
+    }
 
 private:
-    // Your code goes here...
-};
\ No newline at end of file
+    void OnZeroShared() noexcept override {
+        deleter_(ptr_);
+    }
+
+    void OnZeroWeak() noexcept override {
+        delete this;
+    }
+
+    T* ptr_;
+    Deleter deleter_;
+};
+
+// Block of MakeShared and AllocateShared: the counters and the object share
+// one allocation obtained from Allocator, which also frees it
+template <typename T, typename Allocator, LockPolicy Policy = LockPolicy::kAtomic>
+class InplaceControlBlock : public SharedWeakCount<Policy> {
+    using block_allocator =
+        typename std::allocator_traits<Allocator>::template rebind_alloc<InplaceControlBlock>;
+    using block_traits = std::allocator_traits<block_allocator>;
+
+public:
+    template <typename... Args>
+    static InplaceControlBlock* Create(const Allocator& alloc, Args&&... args) {
+        block_allocator block_alloc(alloc);
+        InplaceControlBlock* block = block_traits::allocate(block_alloc, 1);
+        try {
+            ::new (static_cast<void*>(block))
+                InplaceControlBlock(alloc, std::forward<Args>(args)...);
+        } catch (...) {
+            block_traits::deallocate(block_alloc, block, 1);
+            throw;
+        }
+        return block;
+    }
+
+    T* Get() noexcept {
+        return std::launder(reinterpret_cast<T*>(storage_.value));
+    }
+
+private:
+    // Holds an empty allocator without spending a byte on it
+    struct Storage : Allocator {
+        explicit Storage(const Allocator& alloc) : Allocator(alloc) {
+        }
+
+        alignas(T) unsigned char value[sizeof(T)];
+    };
+
+    template <typename... Args>
+    explicit InplaceControlBlock(const Allocator& alloc, Args&&... args) : storage_(alloc) {
+        ::new (static_cast<void*>(storage_.value)) T(std::forward<Args>(args)...);
+    }
+
+    void OnZeroShared() noexcept override {
+        Get()->~T();
+    }
+
+    void OnZeroWeak() noexcept override {
+        block_allocator block_alloc(static_cast<const Allocator&>(storage_));
+        this->~InplaceControlBlock();
+        block_traits::deallocate(block_alloc, this, 1);
+    }
+
+    Storage storage_;
+};
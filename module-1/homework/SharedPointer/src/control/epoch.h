@@ -0,0 +1,255 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Object whose reclamation is deferred by EpochDomain
+class EpochRetired {
+public:
+    virtual ~EpochRetired() = default;
+
+    // Runs once no thread pinned before Retire can still use the object
+    virtual void Reclaim() noexcept = 0;
+
+private:
+    friend class EpochDomain;
+
+    EpochRetired* retired_next_ = nullptr;
+    std::uint64_t retired_epoch_ = 0;
+};
+
+// Process-wide epoch based reclamation (Fraser). A reader pins the current
+// global epoch for the duration of an EpochGuard. An object retired in epoch e
+// is reclaimed once the epoch reaches e + 2: by then every thread pinned in e
+// or earlier has unpinned. The epoch moves forward only when all pinned threads
+// have seen the current one. Retired objects are kept per thread and reclaimed
+// in batches of kBatch, so a reader pays two stores and no read-modify-write
+class EpochDomain {
+public:
+    static constexpr std::size_t kBatch = 64;
+
+    static void Pin() noexcept;
+    static void Unpin() noexcept;
+
+    // Called once no new reference to object can be taken
+    static void Retire(EpochRetired* object) noexcept;
+
+    // Advances the epoch as far as the pinned threads allow and reclaims
+    // what became safe, including objects left by exited threads
+    static void Collect() noexcept;
+
+private:
+    // Per-thread record, never freed: a record of an exited thread is reused
+    struct Record {
+        std::atomic<std::uint64_t> pinned{0};  // 0 if not pinned
+        std::atomic<bool> in_use{true};
+        Record* next = nullptr;
+    };
+
+    // State of the calling thread and the objects it retired. Destructors of
+    // other thread_local objects may still pin and retire after ~Local: a
+    // record is then held only while pinned, and retired objects are orphaned
+    struct Local {
+        ~Local();
+
+        bool alive = true;
+        Record* record = nullptr;
+        std::size_t depth = 0;
+        bool collecting = false;
+        EpochRetired* head = nullptr;
+        EpochRetired* tail = nullptr;
+        std::size_t size = 0;
+        // Objects a stalled reader keeps alive are not rescanned every Retire
+        std::size_t next_collect = kBatch;
+    };
+
+    static Record* Acquire() noexcept;
+    static bool TryAdvance(std::uint64_t epoch) noexcept;
+    static void Append(Local& local, EpochRetired* object) noexcept;
+    // Pushes the chain [head, tail] to the orphans, it keeps its order and epochs
+    static void Orphan(EpochRetired* head, EpochRetired* tail) noexcept;
+    static void ReclaimSafe(Local& local) noexcept;
+
+    static inline std::atomic<std::uint64_t> epoch_{1};
+    static inline std::atomic<Record*> records_{nullptr};
+    // Objects left by exited threads, adopted by the next Collect
+    static inline std::atomic<EpochRetired*> orphans_{nullptr};
+    static thread_local Local local_;
+};
+
+inline thread_local EpochDomain::Local EpochDomain::local_;
+
+// Keeps the objects retired after its construction alive until destruction
+class EpochGuard {
+public:
+    EpochGuard() noexcept {
+        EpochDomain::Pin();
+    }
+
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+
+    ~EpochGuard() {
+        EpochDomain::Unpin();
+    }
+};
+
+inline EpochDomain::Local::~Local() {
+    alive = false;
+    if (head != nullptr) {
+        Orphan(head, tail);
+        head = tail = nullptr;
+        size = 0;
+    }
+    // A guard that is still open gives the record back in Unpin
+    if (record != nullptr && depth == 0) {
+        record->in_use.store(false, std::memory_order_release);
+        record = nullptr;
+    }
+}
+
+inline EpochDomain::Record* EpochDomain::Acquire() noexcept {
+    for (Record* record = records_.load(std::memory_order_acquire); record != nullptr;
+         record = record->next) {
+        bool in_use = false;
+        if (!record->in_use.load(std::memory_order_relaxed) &&
+            record->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire)) {
+            return record;
+        }
+    }
+    auto record = new Record;
+    record->next = records_.load(std::memory_order_relaxed);
+    while (!records_.compare_exchange_weak(record->next, record, std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+    }
+    return record;
+}
+
+inline void EpochDomain::Pin() noexcept {
+    Local& local = local_;
+    if (local.depth++ != 0) {
+        return;
+    }
+    if (local.record == nullptr) {
+        local.record = Acquire();
+    }
+    // The pin must be visible before the epoch is read again, or TryAdvance
+    // could miss this thread and move two epochs past it
+    std::uint64_t epoch = epoch_.load(std::memory_order_relaxed);
+    while (true) {
+        local.record->pinned.store(epoch, std::memory_order_seq_cst);
+        std::uint64_t now = epoch_.load(std::memory_order_seq_cst);
+        if (now == epoch) {
+            return;
+        }
+        epoch = now;
+    }
+}
+
+inline void EpochDomain::Unpin() noexcept {
+    Local& local = local_;
+    if (--local.depth == 0) {
+        local.record->pinned.store(0, std::memory_order_release);
+        if (!local.alive) {
+            local.record->in_use.store(false, std::memory_order_release);
+            local.record = nullptr;
+        }
+    }
+}
+
+inline bool EpochDomain::TryAdvance(std::uint64_t epoch) noexcept {
+    for (Record* record = records_.load(std::memory_order_acquire); record != nullptr;
+         record = record->next) {
+        std::uint64_t pinned = record->pinned.load(std::memory_order_seq_cst);
+        if (pinned != 0 && pinned != epoch) {
+            return false;
+        }
+    }
+    return epoch_.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+}
+
+inline void EpochDomain::Append(Local& local, EpochRetired* object) noexcept {
+    object->retired_next_ = nullptr;
+    if (local.tail == nullptr) {
+        local.head = object;
+    } else {
+        local.tail->retired_next_ = object;
+    }
+    local.tail = object;
+    ++local.size;
+}
+
+inline void EpochDomain::Orphan(EpochRetired* head, EpochRetired* tail) noexcept {
+    EpochRetired* orphans = orphans_.load(std::memory_order_relaxed);
+    do {
+        tail->retired_next_ = orphans;
+    } while (!orphans_.compare_exchange_weak(orphans, head, std::memory_order_release,
+                                             std::memory_order_relaxed));
+}
+
+inline void EpochDomain::Retire(EpochRetired* object) noexcept {
+    Local& local = local_;
+    object->retired_epoch_ = epoch_.load(std::memory_order_seq_cst);
+    if (!local.alive) {
+        Orphan(object, object);
+        return;
+    }
+    Append(local, object);
+    if (local.size >= local.next_collect && !local.collecting) {
+        Collect();
+    }
+}
+
+inline void EpochDomain::Collect() noexcept {
+    // After teardown the thread keeps no list to adopt the orphans into
+    Local& local = local_;
+    if (local.collecting || !local.alive) {
+        return;
+    }
+    if (orphans_.load(std::memory_order_relaxed) != nullptr) {
+        EpochRetired* orphan = orphans_.exchange(nullptr, std::memory_order_acquire);
+        while (orphan != nullptr) {
+            EpochRetired* next = orphan->retired_next_;
+            Append(local, orphan);
+            orphan = next;
+        }
+    }
+    std::uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+    if (TryAdvance(epoch)) {
+        TryAdvance(epoch + 1);
+    }
+    ReclaimSafe(local);
+    local.next_collect = local.size + kBatch;
+}
+
+inline void EpochDomain::ReclaimSafe(Local& local) noexcept {
+    // Reclaiming may retire more objects: they are appended after the ones
+    // already detached
+    local.collecting = true;
+    std::uint64_t safe = epoch_.load(std::memory_order_seq_cst);
+    EpochRetired* ready = nullptr;
+    EpochRetired** ready_tail = &ready;
+    EpochRetired** link = &local.head;
+    EpochRetired* last = nullptr;
+    while (*link != nullptr) {
+        EpochRetired* object = *link;
+        if (object->retired_epoch_ + 2 <= safe) {
+            *link = object->retired_next_;
+            *ready_tail = object;
+            ready_tail = &object->retired_next_;
+            --local.size;
+        } else {
+            last = object;
+            link = &object->retired_next_;
+        }
+    }
+    *ready_tail = nullptr;
+    local.tail = last;
+    while (ready != nullptr) {
+        EpochRetired* next = ready->retired_next_;
+        ready->Reclaim();
+        ready = next;
+    }
+    local.collecting = false;
+}
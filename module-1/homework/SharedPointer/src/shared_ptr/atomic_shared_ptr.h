@@ -0,0 +1,185 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+
+#include "shared_ptr.h"
+
+// SharedPtr that can be loaded and replaced concurrently, for publishing
+// read-mostly snapshots. Every stored value lives in an immutable record and
+// the atomic word holds the record pointer together with the number of
+// readers currently pinning it (split reference count). A reader pins the
+// record, copies the SharedPtr out of it and unpins, so Load never blocks and
+// never allocates. A writer swaps the word and hands the pins it took over to
+// the record, the last pinned reader or the writer frees it.
+//
+// Store and Exchange allocate one record. At most kMaxPins readers may be
+// inside Load of one AtomicSharedPtr at the same time. The pin count takes the
+// top 16 bits of the word, so records must lie in the lower 48 bits of the
+// address space: true for user space on x86-64 with 4-level paging and on
+// AArch64 with 48-bit virtual addresses, but not with 5-level paging (LA57)
+// if the allocator hands out addresses above 2^47. Debug builds check it
+template <typename T>
+class AtomicSharedPtr {
+    static_assert(sizeof(std::uintptr_t) == 8, "The pin count lives in the pointer bits");
+
+public:
+    static constexpr std::uintptr_t kMaxPins = (std::uintptr_t{1} << 16) - 1;
+
+    constexpr AtomicSharedPtr() noexcept = default;
+    explicit AtomicSharedPtr(SharedPtr<T> desired) : word_(Pack(MakeRecord(std::move(desired)))) {
+    }
+
+    AtomicSharedPtr(const AtomicSharedPtr&) = delete;
+    AtomicSharedPtr& operator=(const AtomicSharedPtr&) = delete;
+
+    // Not thread safe, like any destructor
+    ~AtomicSharedPtr() {
+        delete RecordOf(word_.load(std::memory_order_relaxed));
+    }
+
+    SharedPtr<T> Load() const noexcept;
+
+    void Store(SharedPtr<T> desired) {
+        Exchange(std::move(desired));
+    }
+
+    SharedPtr<T> Exchange(SharedPtr<T> desired);
+
+    // Replaces the value by desired if it still shares the object and the
+    // control block of expected, otherwise loads the value into expected
+    bool CompareExchange(SharedPtr<T>& expected, SharedPtr<T> desired);
+
+private:
+    struct Record {
+        explicit Record(SharedPtr<T> value) noexcept : value(std::move(value)) {
+        }
+
+        // Pins handed over by the writer minus pins released after the
+        // swap, the record is freed once this drops back to zero
+        std::atomic<std::int64_t> unpinned_late{0};
+        SharedPtr<T> value;
+    };
+
+    static constexpr int kPinShift = 48;
+    static constexpr std::uintptr_t kPin = std::uintptr_t{1} << kPinShift;
+    static constexpr std::uintptr_t kRecordMask = kPin - 1;
+
+    static Record* MakeRecord(SharedPtr<T> value) {
+        return value ? new Record(std::move(value)) : nullptr;
+    }
+
+    static std::uintptr_t Pack(Record* record) noexcept {
+        auto raw = reinterpret_cast<std::uintptr_t>(record);
+        assert((raw >> kPinShift) == 0 && "Record address does not fit in 48 bits");
+        return raw;
+    }
+
+    static Record* RecordOf(std::uintptr_t word) noexcept {
+        return reinterpret_cast<Record*>(word & kRecordMask);
+    }
+
+    static std::int64_t PinsOf(std::uintptr_t word) noexcept {
+        return static_cast<std::int64_t>(word >> kPinShift);
+    }
+
+    static bool SameOwner(const SharedPtr<T>& lhs, const SharedPtr<T>& rhs) noexcept {
+        return lhs.ptr_ == rhs.ptr_ && lhs.control_ == rhs.control_;
+    }
+
+    // Releases a pin taken on record while word was loaded
+    void Unpin(Record* record) const noexcept;
+
+    // Called by the writer which swapped record out: transfers the pins left
+    // in the swapped word
+    static void Retire(std::uintptr_t word, std::int64_t own_pins) noexcept;
+
+    static void Unpinned(Record* record, std::int64_t count) noexcept {
+        if (record->unpinned_late.fetch_add(count, std::memory_order_acq_rel) + count == 0) {
+            delete record;
+        }
+    }
+
+    mutable std::atomic<std::uintptr_t> word_{0};
+};
+
+template <typename T>
+SharedPtr<T> AtomicSharedPtr<T>::Load() const noexcept {
+    if (RecordOf(word_.load(std::memory_order_relaxed)) == nullptr) {
+        return SharedPtr<T>();
+    }
+    std::uintptr_t word = word_.fetch_add(kPin, std::memory_order_acquire);
+    Record* record = RecordOf(word);
+    if (record == nullptr) {
+        Unpin(record);
+        return SharedPtr<T>();
+    }
+    SharedPtr<T> result = record->value;
+    Unpin(record);
+    return result;
+}
+
+template <typename T>
+SharedPtr<T> AtomicSharedPtr<T>::Exchange(SharedPtr<T> desired) {
+    Record* record = MakeRecord(std::move(desired));
+    std::uintptr_t old = word_.exchange(Pack(record), std::memory_order_acq_rel);
+    Record* old_record = RecordOf(old);
+    if (old_record == nullptr) {
+        return SharedPtr<T>();
+    }
+    SharedPtr<T> result = old_record->value;
+    Retire(old, 0);
+    return result;
+}
+
+template <typename T>
+bool AtomicSharedPtr<T>::CompareExchange(SharedPtr<T>& expected, SharedPtr<T> desired) {
+    std::uintptr_t word = word_.fetch_add(kPin, std::memory_order_acquire);
+    Record* current = RecordOf(word);
+    bool equal = current == nullptr ? !expected : SameOwner(current->value, expected);
+    if (!equal) {
+        expected = current == nullptr ? SharedPtr<T>() : current->value;
+        Unpin(current);
+        return false;
+    }
+
+    Record* record = MakeRecord(std::move(desired));
+    word += kPin;
+    while (RecordOf(word) == current) {
+        if (word_.compare_exchange_weak(word, Pack(record), std::memory_order_acq_rel,
+                                        std::memory_order_acquire)) {
+            if (current != nullptr) {
+                Retire(word, 1);
+            }
+            return true;
+        }
+    }
+
+    // Another writer replaced the record while it was being compared
+    delete record;
+    expected = current == nullptr ? SharedPtr<T>() : current->value;
+    Unpin(current);
+    return false;
+}
+
+template <typename T>
+void AtomicSharedPtr<T>::Unpin(Record* record) const noexcept {
+    std::uintptr_t word = word_.load(std::memory_order_relaxed);
+    while (RecordOf(word) == record) {
+        if (word_.compare_exchange_weak(word, word - kPin, std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+            return;
+        }
+    }
+    // The writer which swapped the record out counted this pin
+    if (record != nullptr) {
+        Unpinned(record, -1);
+    }
+}
+
+template <typename T>
+void AtomicSharedPtr<T>::Retire(std::uintptr_t word, std::int64_t own_pins) noexcept {
+    Unpinned(RecordOf(word), PinsOf(word) - own_pins);
+}
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "../control/control.h"
+
+// Returns an object created by AllocateIntrusive to a stateless allocator
+template <typename Allocator>
+struct AllocatorDelete {
+    template <typename T>
+    void operator()(T* p) const noexcept {
+        using object_allocator =
+            typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+        using object_traits = std::allocator_traits<object_allocator>;
+        object_allocator alloc;
+        object_traits::destroy(alloc, p);
+        object_traits::deallocate(alloc, p, 1);
+    }
+};
+
+template <typename T>
+class IntrusivePtr;
+
+template <typename T, typename... Args>
+IntrusivePtr<T> MakeIntrusive(Args&&... args);
+
+template <typename T, typename Allocator, typename... Args>
+IntrusivePtr<T> AllocateIntrusive(const Allocator& alloc, Args&&... args);
+
+// Base of objects owned by IntrusivePtr: the counter lives in the object
+// itself, so there is no control block, no second allocation and no
+// indirection. Deleter frees the complete Derived object when the last
+// IntrusivePtr is gone. There are no weak references
+template <typename Derived, LockPolicy Policy = LockPolicy::kAtomic,
+          typename Deleter = std::default_delete<Derived>>
+class IntrusiveRefCounted {
+    static_assert(Policy == LockPolicy::kAtomic || Policy == LockPolicy::kSingle,
+                  "Biased and epoch counting need a control block");
+
+public:
+    using deleter_type = Deleter;
+
+    int64_t UseCount() const noexcept {
+        return static_cast<int64_t>(refs_.Load());
+    }
+
+    template <typename U>
+    friend class IntrusivePtr;
+
+    template <typename U, typename... Args>
+    friend IntrusivePtr<U> MakeIntrusive(Args&&... args);
+
+    template <typename U, typename Allocator, typename... Args>
+    friend IntrusivePtr<U> AllocateIntrusive(const Allocator& alloc, Args&&... args);
+
+protected:
+    IntrusiveRefCounted() noexcept : refs_(0) {
+    }
+    // A copy is a new object without owners
+    IntrusiveRefCounted(const IntrusiveRefCounted&) noexcept : refs_(0) {
+    }
+    IntrusiveRefCounted& operator=(const IntrusiveRefCounted&) noexcept {
+        return *this;
+    }
+    ~IntrusiveRefCounted() = default;
+
+private:
+    // A new object gets its first owner without a read-modify-write
+    void SetFirstRef() noexcept {
+        refs_.Store(1);
+    }
+
+    void AddRef() noexcept {
+        refs_.Increment();
+    }
+
+    void ReleaseRef() noexcept {
+        if (refs_.Decrement() == 1) {
+            Deleter()(static_cast<Derived*>(this));
+        }
+    }
+
+    RefCount<Policy> refs_;
+};
+
+// Pointer of the size of T* to an object derived from IntrusiveRefCounted
+template <typename T>
+class IntrusivePtr {
+public:
+    using element_type = T;
+
+    constexpr IntrusivePtr() noexcept = default;
+    // Adds an owner to p, which may already be owned by other IntrusivePtr
+    explicit IntrusivePtr(T* p) noexcept;
+    ~IntrusivePtr();
+
+    IntrusivePtr(const IntrusivePtr& other) noexcept;
+    IntrusivePtr(IntrusivePtr&& other) noexcept;
+
+    template <typename Y>
+    IntrusivePtr(const IntrusivePtr<Y>& other) noexcept;  // NOLINT
+
+    template <typename Y>
+    IntrusivePtr(IntrusivePtr<Y>&& other) noexcept;  // NOLINT
+
+    IntrusivePtr& operator=(const IntrusivePtr& r) noexcept;
+    IntrusivePtr& operator=(IntrusivePtr&& r) noexcept;
+
+    // Modifiers
+    void Reset() noexcept;
+    void Reset(T* p) noexcept;
+    void Swap(IntrusivePtr& other) noexcept;
+
+    // Observers
+    T* Get() const noexcept;
+    int64_t UseCount() const noexcept;
+    T& operator*() const noexcept;
+    T* operator->() const noexcept;
+    explicit operator bool() const noexcept;
+
+    template <typename U>
+    friend class IntrusivePtr;
+
+    template <typename U, typename... Args>
+    friend IntrusivePtr<U> MakeIntrusive(Args&&... args);
+
+    template <typename U, typename Allocator, typename... Args>
+    friend IntrusivePtr<U> AllocateIntrusive(const Allocator& alloc, Args&&... args);
+
+private:
+    struct AdoptTag {};
+
+    // Takes over the first reference of a new object
+    IntrusivePtr(AdoptTag, T* p) noexcept : ptr_(p) {
+        ptr_->SetFirstRef();
+    }
+
+    T* ptr_ = nullptr;
+};
+
+// The object is taken from new, T must be freed by std::default_delete
+template <typename T, typename... Args>
+IntrusivePtr<T> MakeIntrusive(Args&&... args) {
+    static_assert(std::is_same_v<typename T::deleter_type, std::default_delete<T>>,
+                  "T is not freed by delete, use AllocateIntrusive");
+
+    T* p = new T(std::forward<Args>(args)...);
+    return IntrusivePtr<T>(typename IntrusivePtr<T>::AdoptTag(), p);
+}
+
+// The object is taken from alloc, T must be freed by AllocatorDelete of the
+// same allocator
+template <typename T, typename Allocator, typename... Args>
+IntrusivePtr<T> AllocateIntrusive(const Allocator& alloc, Args&&... args) {
+    using object_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+    using object_traits = std::allocator_traits<object_allocator>;
+    static_assert(std::is_same_v<typename T::deleter_type, AllocatorDelete<object_allocator>>,
+                  "T is not returned to this allocator");
+
+    object_allocator object_alloc(alloc);
+    T* p = object_traits::allocate(object_alloc, 1);
+    try {
+        object_traits::construct(object_alloc, p, std::forward<Args>(args)...);
+    } catch (...) {
+        object_traits::deallocate(object_alloc, p, 1);
+        throw;
+    }
+    return IntrusivePtr<T>(typename IntrusivePtr<T>::AdoptTag(), p);
+}
+
+template <typename T>
+IntrusivePtr<T>::IntrusivePtr(T* p) noexcept : ptr_(p) {
+    if (ptr_ != nullptr) {
+        ptr_->AddRef();
+    }
+}
+
+template <typename T>
+IntrusivePtr<T>::~IntrusivePtr() {
+    if (ptr_ != nullptr) {
+        ptr_->ReleaseRef();
+    }
+}
+
+template <typename T>
+IntrusivePtr<T>::IntrusivePtr(const IntrusivePtr& other) noexcept : IntrusivePtr(other.ptr_) {
+}
+
+template <typename T>
+IntrusivePtr<T>::IntrusivePtr(IntrusivePtr&& other) noexcept
+    : ptr_(std::exchange(other.ptr_, nullptr)) {
+}
+
+template <typename T>
+template <typename Y>
+IntrusivePtr<T>::IntrusivePtr(const IntrusivePtr<Y>& other) noexcept : IntrusivePtr(other.ptr_) {
+}
+
+template <typename T>
+template <typename Y>
+IntrusivePtr<T>::IntrusivePtr(IntrusivePtr<Y>&& other) noexcept
+    : ptr_(std::exchange(other.ptr_, nullptr)) {
+}
+
+template <typename T>
+IntrusivePtr<T>& IntrusivePtr<T>::operator=(const IntrusivePtr& r) noexcept {
+    IntrusivePtr(r).Swap(*this);
+    return *this;
+}
+
+template <typename T>
+IntrusivePtr<T>& IntrusivePtr<T>::operator=(IntrusivePtr&& r) noexcept {
+    IntrusivePtr(std::move(r)).Swap(*this);
+    return *this;
+}
+
+template <typename T>
+void IntrusivePtr<T>::Reset() noexcept {
+    IntrusivePtr().Swap(*this);
+}
+
+template <typename T>
+void IntrusivePtr<T>::Reset(T* p) noexcept {
+    IntrusivePtr(p).Swap(*this);
+}
+
+template <typename T>
+void IntrusivePtr<T>::Swap(IntrusivePtr& other) noexcept {
+    std::swap(ptr_, other.ptr_);
+}
+
+template <typename T>
+T* IntrusivePtr<T>::Get() const noexcept {
+    return ptr_;
+}
+
+template <typename T>
+int64_t IntrusivePtr<T>::UseCount() const noexcept {
+    return ptr_ == nullptr ? 0 : ptr_->UseCount();
+}
+
+template <typename T>
+T& IntrusivePtr<T>::operator*() const noexcept {
+    return *ptr_;
+}
+
+template <typename T>
+T* IntrusivePtr<T>::operator->() const noexcept {
+    return ptr_;
+}
+
+template <typename T>
+IntrusivePtr<T>::operator bool() const noexcept {
+    return ptr_ != nullptr;
+}
@@ -1,15 +1,43 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
 #include "../control/control.h"
 
 // SharedPtr
-template <typename T>
+template <typename T, LockPolicy Policy = LockPolicy::kAtomic>
 class WeakPtr;
 
-template <typename T>
+template <typename T, LockPolicy Policy = LockPolicy::kAtomic>
+class SharedPtr;
+
+template <typename T, LockPolicy Policy = LockPolicy::kAtomic, typename Allocator,
+          typename... Args>
+SharedPtr<T, Policy> AllocateShared(const Allocator& alloc, Args&&... args);
+
+// True if Y derives from an EnableSharedFromThis: its hidden friend
+// EnableSharedFromThisBase is then found by argument-dependent lookup
+template <typename Y, typename = void>
+struct HasSharedFromThis : std::false_type {};
+
+template <typename Y>
+struct HasSharedFromThis<Y, std::void_t<decltype(EnableSharedFromThisBase(std::declval<Y*>()))>>
+    : std::true_type {};
+
+// Policy selects how the counters are updated, SharedPtr and WeakPtr of one
+// object must agree on it
+template <typename T, LockPolicy Policy>
 class SharedPtr {
+    struct NicheAccess;
+
 public:
-    using element_type =     // Your code goes here...
+    using element_type = std::remove_extent_t<T>;
+    // The niche of task::Optional<SharedPtr>, which then needs no flag
+    using niche_traits = NicheAccess;
 
     constexpr SharedPtr() noexcept = default;
     ~SharedPtr();
@@ -23,15 +51,29 @@ public:
     SharedPtr(const SharedPtr& other) noexcept;
     SharedPtr(SharedPtr&& other) noexcept;
 
+    template <typename Y>
+    SharedPtr(const SharedPtr<Y, Policy>& other) noexcept;  // NOLINT
+
+    template <typename Y>
+    SharedPtr(SharedPtr<Y, Policy>&& other) noexcept;  // NOLINT
+
+    // Aliasing: shares the ownership of other but points to ptr, usually a
+    // member of the owned object. Neither allocates a control block
+    template <typename Y>
+    SharedPtr(const SharedPtr<Y, Policy>& other, T* ptr) noexcept;
+
+    template <typename Y>
+    SharedPtr(SharedPtr<Y, Policy>&& other, T* ptr) noexcept;
+
     SharedPtr& operator=(const SharedPtr& r) noexcept;
 
     template <typename Y>
-    SharedPtr& operator=(const SharedPtr<Y>& r) noexcept;
+    SharedPtr& operator=(const SharedPtr<Y, Policy>& r) noexcept;
 
     SharedPtr& operator=(SharedPtr&& r) noexcept;
 
     template <typename Y>
-    SharedPtr& operator=(SharedPtr<Y>&& r) noexcept;
+    SharedPtr& operator=(SharedPtr<Y, Policy>&& r) noexcept;
 
     // Modifiers
     void Reset() noexcept;
@@ -52,37 +94,247 @@ public:
     element_type& operator[](std::ptrdiff_t idx) const;
     explicit operator bool() const noexcept;
 
-    template <typename U>
+    template <typename U, LockPolicy>
     friend class WeakPtr;
 
+    template <typename U, LockPolicy>
+    friend class SharedPtr;
+
+    template <typename U, LockPolicy P, typename Allocator, typename... Args>
+    friend SharedPtr<U, P> AllocateShared(const Allocator& alloc, Args&&... args);
+
+    template <typename U>
+    friend class AtomicSharedPtr;
+
 private:
-    // Your code goes here...
-};
+    struct AdoptTag {};
+
+    // No control block lives at address 1. The niche owns nothing and is
+    // never destroyed
+    struct NicheAccess {
+        static SharedWeakCount<Policy>* Control() noexcept {
+            return reinterpret_cast<SharedWeakCount<Policy>*>(std::uintptr_t{1});
+        }
+        static SharedPtr Niche() noexcept {
+            return SharedPtr(AdoptTag(), nullptr, Control());
+        }
+        static bool IsNiche(const SharedPtr& value) noexcept {
+            return value.control_ == Control();
+        }
+    };
+
+    // Takes over a reference already counted in control
+    SharedPtr(AdoptTag, T* ptr, SharedWeakCount<Policy>* control) noexcept
+        : ptr_(ptr), control_(control) {
+    }
+
+    // Called once a new control block owns p
+    template <typename Y>
+    void EnableWeakThis(Y* p) noexcept;
 
+    T* ptr_ = nullptr;
+    SharedWeakCount<Policy>* control_ = nullptr;
+};
 
 // MakeShared
-// Your code goes here...
+// The object is constructed inside its control block: one allocation instead
+// of two and no pointer chasing between the counters and the object
+template <typename T, LockPolicy Policy, typename Allocator, typename... Args>
+SharedPtr<T, Policy> AllocateShared(const Allocator& alloc, Args&&... args) {
+    using block_allocator =
+        typename std::allocator_traits<Allocator>::template rebind_alloc<std::remove_cv_t<T>>;
+    auto block = InplaceControlBlock<std::remove_cv_t<T>, block_allocator, Policy>::Create(
+        block_allocator(alloc), std::forward<Args>(args)...);
+    SharedPtr<T, Policy> result(typename SharedPtr<T, Policy>::AdoptTag(), block->Get(), block);
+    result.EnableWeakThis(block->Get());
+    return result;
+}
+
+template <typename T, LockPolicy Policy = LockPolicy::kAtomic, typename... Args>
+SharedPtr<T, Policy> MakeShared(Args&&... args) {
+    return AllocateShared<T, Policy>(std::allocator<std::remove_cv_t<T>>(),
+                                     std::forward<Args>(args)...);
+}
 // MakeShared
 
 // SharedPtr
-// Your code goes here...
+template <typename T, LockPolicy Policy>
+SharedPtr<T, Policy>::~SharedPtr() {
+    if (control_ != nullptr) {
+        control_->Release();
+    }
+}
+
+template <typename T, LockPolicy Policy>
+template <typename Y>
+SharedPtr<T, Policy>::SharedPtr(Y* p) : ptr_(p) {
+    try {
+        control_ =
+            new ControlBlock<Y, std::default_delete<Y>, Policy>(p, std::default_delete<Y>());
+    } catch (...) {
+        delete p;
+        throw;
+    }
+    EnableWeakThis(p);
+}
+
+template <typename T, LockPolicy Policy>
+template <typename Y, typename Deleter>
+SharedPtr<T, Policy>::SharedPtr(Y* p, Deleter deleter) noexcept
+    : ptr_(p), control_(new ControlBlock<Y, Deleter, Policy>(p, std::move(deleter))) {
+    EnableWeakThis(p);
+}
+
+template <typename T, LockPolicy Policy>
+SharedPtr<T, Policy>::SharedPtr(const SharedPtr& other) noexcept
+    : ptr_(other.ptr_), control_(other.control_) {
+    if (control_ != nullptr) {
+        control_->AddShared();
+    }
+}
+
+template <typename T, LockPolicy Policy>
+SharedPtr<T, Policy>::SharedPtr(SharedPtr&& other) noexcept
+    : ptr_(std::exchange(other.ptr_, nullptr)), control_(std::exchange(other.control_, nullptr)) {
+}
+
+template <typename T, LockPolicy Policy>
+template <typename Y>
+SharedPtr<T, Policy>::SharedPtr(const SharedPtr<Y, Policy>& other) noexcept
+    : ptr_(other.ptr_), control_(other.control_) {
+    if (control_ != nullptr) {
+        control_->AddShared();
+    }
+}
+
+template <typename T, LockPolicy Policy>
+template <typename Y>
+SharedPtr<T, Policy>::SharedPtr(SharedPtr<Y, Policy>&& other) noexcept
+    : ptr_(std::exchange(other.ptr_, nullptr)), control_(std::exchange(other.control_, nullptr)) {
+}
+
+template <typename T, LockPolicy Policy>
+template <typename Y>
+SharedPtr<T, Policy>::SharedPtr(const SharedPtr<Y, Policy>& other, T* ptr) noexcept
+    : ptr_(ptr), control_(other.control_) {
+    if (control_ != nullptr) {
+        control_->AddShared();
+    }
+}
+
+template <typename T, LockPolicy Policy>
+template <typename Y>
+SharedPtr<T, Policy>::SharedPtr(SharedPtr<Y, Policy>&& other, T* ptr) noexcept
+    : ptr_(ptr), control_(std::exchange(other.control_, nullptr)) {
+    other.ptr_ = nullptr;
+}
+
+template <typename T, LockPolicy Policy>
+SharedPtr<T, Policy>& SharedPtr<T, Policy>::operator=(const SharedPtr& r) noexcept {
+    SharedPtr(r).Swap(*this);
+    return *this;
+}
+
+template <typename T, LockPolicy Policy>
+template <typename Y>
+SharedPtr<T, Policy>& SharedPtr<T, Policy>::operator=(const SharedPtr<Y, Policy>& r) noexcept {
+    SharedPtr(r).Swap(*this);
+    return *this;
+}
+
+template <typename T, LockPolicy Policy>
+SharedPtr<T, Policy>& SharedPtr<T, Policy>::operator=(SharedPtr&& r) noexcept {
+    SharedPtr(std::move(r)).Swap(*this);
+    return *this;
+}
+
+template <typename T, LockPolicy Policy>
+template <typename Y>
+SharedPtr<T, Policy>& SharedPtr<T, Policy>::operator=(SharedPtr<Y, Policy>&& r) noexcept {
+    SharedPtr(std::move(r)).Swap(*this);
+    return *this;
+}
+
+template <typename T, LockPolicy Policy>
+void SharedPtr<T, Policy>::Reset() noexcept {
+    SharedPtr().Swap(*this);
+}
+
+template <typename T, LockPolicy Policy>
+template <typename Y>
+void SharedPtr<T, Policy>::Reset(Y* p) noexcept {
+    SharedPtr(p).Swap(*this);
+}
+
+template <typename T, LockPolicy Policy>
+template <typename Y, typename Deleter>
+void SharedPtr<T, Policy>::Reset(Y* p, Deleter deleter) noexcept {
+    SharedPtr(p, std::move(deleter)).Swap(*this);
+}
+
+template <typename T, LockPolicy Policy>
+void SharedPtr<T, Policy>::Swap(SharedPtr& other) noexcept {
+    std::swap(ptr_, other.ptr_);
+    std::swap(control_, other.control_);
+}
+
+template <typename T, LockPolicy Policy>
+template <typename Y>
+void SharedPtr<T, Policy>::EnableWeakThis(Y* p) noexcept {
+    if constexpr (HasSharedFromThis<Y>::value) {
+        if (p != nullptr) {
+            EnableSharedFromThisBase(p)->AdoptOwner(*this, p);
+        }
+    }
+}
+
+template <typename T, LockPolicy Policy>
+T* SharedPtr<T, Policy>::Get() const noexcept {
+    return ptr_;
+}
+
+template <typename T, LockPolicy Policy>
+int64_t SharedPtr<T, Policy>::UseCount() const noexcept {
+    return control_ == nullptr ? 0 : static_cast<int64_t>(control_->UseCount());
+}
+
+template <typename T, LockPolicy Policy>
+T& SharedPtr<T, Policy>::operator*() const noexcept {
+    return *ptr_;
+}
+
+template <typename T, LockPolicy Policy>
+T* SharedPtr<T, Policy>::operator->() const noexcept {
+    return ptr_;
+}
+
+template <typename T, LockPolicy Policy>
+typename SharedPtr<T, Policy>::element_type& SharedPtr<T, Policy>::operator[](
+    std::ptrdiff_t idx) const {
+    return ptr_[idx];
+}
+
+template <typename T, LockPolicy Policy>
+SharedPtr<T, Policy>::operator bool() const noexcept {
+    return ptr_ != nullptr;
+}
 // SharedPtr
 
 // WeakPtr
-template <typename T>
+template <typename T, LockPolicy Policy>
 class WeakPtr {
 
 public:
-    using element_type =     // Your code goes here...
+    using element_type = std::remove_extent_t<T>;
 
     // Special-member functions
     constexpr WeakPtr() noexcept = default;
     template <typename Y>
-    explicit WeakPtr(const SharedPtr<Y>& other);
+    explicit WeakPtr(const SharedPtr<Y, Policy>& other);
     WeakPtr(const WeakPtr& other) noexcept;
     WeakPtr(WeakPtr&& other) noexcept;
     template <typename Y>
-    WeakPtr& operator=(const SharedPtr<Y>& other);
+    WeakPtr& operator=(const SharedPtr<Y, Policy>& other);
     WeakPtr& operator=(const WeakPtr& other) noexcept;
     WeakPtr& operator=(WeakPtr&& other) noexcept;
 
@@ -90,19 +342,153 @@ public:
 
     // Modifiers
     void Reset() noexcept;
-    void Swap(WeakPtr<T>& other) noexcept;
+    void Swap(WeakPtr<T, Policy>& other) noexcept;
 
     // Observers
     bool Expired() noexcept;
-    SharedPtr<T> Lock() const noexcept;
+    SharedPtr<T, Policy> Lock() const noexcept;
 
-    template <typename U>
+    // LockPolicy::kEpoch only: the object without taking a reference, nullptr
+    // once expired. Stays valid until guard is destroyed
+    T* Borrow(const EpochGuard& guard) const noexcept;
+
+    template <typename U, LockPolicy>
     friend class SharedPtr;
 
-public:
-    // Your code goes here...
+private:
+    T* ptr_ = nullptr;
+    SharedWeakCount<Policy>* control_ = nullptr;
 };
 
 // WeakPtr
-// Your code goes here...
-// WeakPtr
\ No newline at end of file
+template <typename T, LockPolicy Policy>
+template <typename Y>
+WeakPtr<T, Policy>::WeakPtr(const SharedPtr<Y, Policy>& other)
+    : ptr_(other.ptr_), control_(other.control_) {
+    if (control_ != nullptr) {
+        control_->AddWeak();
+    }
+}
+
+template <typename T, LockPolicy Policy>
+WeakPtr<T, Policy>::WeakPtr(const WeakPtr& other) noexcept
+    : ptr_(other.ptr_), control_(other.control_) {
+    if (control_ != nullptr) {
+        control_->AddWeak();
+    }
+}
+
+template <typename T, LockPolicy Policy>
+WeakPtr<T, Policy>::WeakPtr(WeakPtr&& other) noexcept
+    : ptr_(std::exchange(other.ptr_, nullptr)), control_(std::exchange(other.control_, nullptr)) {
+}
+
+template <typename T, LockPolicy Policy>
+template <typename Y>
+WeakPtr<T, Policy>& WeakPtr<T, Policy>::operator=(const SharedPtr<Y, Policy>& other) {
+    WeakPtr(other).Swap(*this);
+    return *this;
+}
+
+template <typename T, LockPolicy Policy>
+WeakPtr<T, Policy>& WeakPtr<T, Policy>::operator=(const WeakPtr& other) noexcept {
+    WeakPtr(other).Swap(*this);
+    return *this;
+}
+
+template <typename T, LockPolicy Policy>
+WeakPtr<T, Policy>& WeakPtr<T, Policy>::operator=(WeakPtr&& other) noexcept {
+    WeakPtr(std::move(other)).Swap(*this);
+    return *this;
+}
+
+template <typename T, LockPolicy Policy>
+WeakPtr<T, Policy>::~WeakPtr() {
+    if (control_ != nullptr) {
+        control_->ReleaseWeak();
+    }
+}
+
+template <typename T, LockPolicy Policy>
+void WeakPtr<T, Policy>::Reset() noexcept {
+    WeakPtr().Swap(*this);
+}
+
+template <typename T, LockPolicy Policy>
+void WeakPtr<T, Policy>::Swap(WeakPtr<T, Policy>& other) noexcept {
+    std::swap(ptr_, other.ptr_);
+    std::swap(control_, other.control_);
+}
+
+template <typename T, LockPolicy Policy>
+bool WeakPtr<T, Policy>::Expired() noexcept {
+    return control_ == nullptr || control_->UseCount() == 0;
+}
+
+template <typename T, LockPolicy Policy>
+SharedPtr<T, Policy> WeakPtr<T, Policy>::Lock() const noexcept {
+    if (control_ != nullptr && control_->Lock()) {
+        return SharedPtr<T, Policy>(typename SharedPtr<T, Policy>::AdoptTag(), ptr_, control_);
+    }
+    return SharedPtr<T, Policy>();
+}
+
+template <typename T, LockPolicy Policy>
+T* WeakPtr<T, Policy>::Borrow(const EpochGuard&) const noexcept {
+    static_assert(Policy == LockPolicy::kEpoch, "Only epoch blocks defer the destruction");
+    return control_ != nullptr && control_->UseCount() != 0 ? ptr_ : nullptr;
+}
+// WeakPtr
+
+// EnableSharedFromThis
+// Base for objects which hand out owners of themselves. The WeakPtr inside is
+// set when the first SharedPtr takes the object, so SharedFromThis only bumps
+// the counter of the existing control block. Until then SharedFromThis returns
+// an empty pointer
+template <typename T, LockPolicy Policy = LockPolicy::kAtomic>
+class EnableSharedFromThis {
+public:
+    SharedPtr<T, Policy> SharedFromThis() {
+        return weak_this_.Lock();
+    }
+    SharedPtr<const T, Policy> SharedFromThis() const {
+        return weak_this_.Lock();
+    }
+
+    WeakPtr<T, Policy> WeakFromThis() noexcept {
+        return weak_this_;
+    }
+    WeakPtr<const T, Policy> WeakFromThis() const noexcept {
+        return WeakPtr<const T, Policy>(weak_this_.Lock());
+    }
+
+    template <typename U, LockPolicy>
+    friend class SharedPtr;
+
+protected:
+    constexpr EnableSharedFromThis() noexcept = default;
+    // A copy is a different object, it is not owned by the owners of other
+    EnableSharedFromThis(const EnableSharedFromThis&) noexcept {
+    }
+    EnableSharedFromThis& operator=(const EnableSharedFromThis&) noexcept {
+        return *this;
+    }
+    ~EnableSharedFromThis() = default;
+
+private:
+    friend const EnableSharedFromThis* EnableSharedFromThisBase(
+        const EnableSharedFromThis* p) noexcept {
+        return p;
+    }
+
+    // Keeps the first owner, like std::enable_shared_from_this
+    template <typename Y, typename U>
+    void AdoptOwner(const SharedPtr<Y, Policy>& owner, U* p) const noexcept {
+        if (weak_this_.Expired()) {
+            weak_this_ = SharedPtr<T, Policy>(owner, static_cast<T*>(p));
+        }
+    }
+
+    mutable WeakPtr<T, Policy> weak_this_;
+};
+// EnableSharedFromThis
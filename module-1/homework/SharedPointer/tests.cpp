@@ -1,7 +1,14 @@
 #include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
+#include "src/shared_ptr/atomic_shared_ptr.h"
+#include "src/shared_ptr/intrusive_ptr.h"
 #include "src/shared_ptr/shared_ptr.h"
 
 // WeakPtr
@@ -157,6 +164,392 @@ TEST(SharedBoolOperator, Test2) {
     ASSERT_FALSE(s1);
 }
 
+// The niche is neither an empty nor an owning pointer and is never destroyed
+TEST(SharedNiche, Test1) {
+    using Niche = SharedPtr<int32_t>::niche_traits;
+    alignas(SharedPtr<int32_t>) unsigned char storage[sizeof(SharedPtr<int32_t>)];
+    auto* niche = ::new (static_cast<void*>(storage)) SharedPtr<int32_t>(Niche::Niche());
+    ASSERT_TRUE(Niche::IsNiche(*niche));
+    ASSERT_FALSE(Niche::IsNiche(SharedPtr<int32_t>()));
+    ASSERT_FALSE(Niche::IsNiche(MakeShared<int32_t>(1)));
+}
+
+// Tracks the number of its live instances
+struct Counted {
+    explicit Counted(int* alive) : alive(alive) {
+        ++*alive;
+    }
+    ~Counted() {
+        --*alive;
+    }
+    int* alive;
+};
+
+// LockPolicy
+TEST(SinglePolicy, Test1) {
+    WeakPtr<std::string, LockPolicy::kSingle> w;
+    {
+        auto sp = MakeShared<std::string, LockPolicy::kSingle>("hello");
+        SharedPtr<std::string, LockPolicy::kSingle> copy = sp;
+        w = copy;
+        ASSERT_EQ(sp.UseCount(), 2);
+        ASSERT_EQ(*w.Lock(), "hello");
+    }
+    ASSERT_TRUE(w.Expired() && !w.Lock());
+}
+
+TEST(BiasedPolicy, Test1) {
+    WeakPtr<std::string, LockPolicy::kBiased> w;
+    {
+        auto sp = MakeShared<std::string, LockPolicy::kBiased>("hello");
+        SharedPtr<std::string, LockPolicy::kBiased> copy = sp;
+        w = copy;
+        ASSERT_EQ(sp.UseCount(), 2);
+        ASSERT_EQ(*w.Lock(), "hello");
+    }
+    ASSERT_TRUE(w.Expired() && !w.Lock());
+}
+
+TEST(BiasedPolicy, ReleasedByOtherThread) {
+    int alive = 0;
+    auto sp = MakeShared<Counted, LockPolicy::kBiased>(&alive);
+    std::thread([copy = sp]() mutable { copy.Reset(); }).join();
+    ASSERT_EQ(sp.UseCount(), 1);
+
+    // The other thread dropped a reference counted by this one, the block
+    // waits in the queue of this thread until its next MakeShared
+    sp.Reset();
+    ASSERT_EQ(alive, 1);
+    MakeShared<int32_t, LockPolicy::kBiased>(0);
+    ASSERT_EQ(alive, 0);
+}
+
+TEST(BiasedPolicy, OwnerExited) {
+    int alive = 0;
+    SharedPtr<Counted, LockPolicy::kBiased> sp;
+    std::thread([&sp, &alive] { sp = MakeShared<Counted, LockPolicy::kBiased>(&alive); }).join();
+    ASSERT_EQ(sp.UseCount(), 1);
+    sp.Reset();
+    ASSERT_EQ(alive, 0);
+}
+
+TEST(EpochPolicy, Test1) {
+    int alive = 0;
+    WeakPtr<Counted, LockPolicy::kEpoch> w;
+    {
+        auto sp = MakeShared<Counted, LockPolicy::kEpoch>(&alive);
+        SharedPtr<Counted, LockPolicy::kEpoch> copy = sp;
+        w = copy;
+        ASSERT_EQ(sp.UseCount(), 2);
+        ASSERT_EQ(w.Lock().Get(), sp.Get());
+    }
+    // Expired at once, destroyed by the domain
+    ASSERT_TRUE(w.Expired() && !w.Lock());
+    EpochDomain::Collect();
+    ASSERT_EQ(alive, 0);
+}
+
+TEST(EpochPolicy, Borrow) {
+    int alive = 0;
+    auto sp = MakeShared<Counted, LockPolicy::kEpoch>(&alive);
+    WeakPtr<Counted, LockPolicy::kEpoch> w(sp);
+    {
+        EpochGuard guard;
+        Counted* borrowed = w.Borrow(guard);
+        ASSERT_TRUE(borrowed == sp.Get() && sp.UseCount() == 1);
+
+        sp.Reset();
+        EpochDomain::Collect();
+        ASSERT_TRUE(w.Borrow(guard) == nullptr && borrowed->alive == &alive && alive == 1);
+    }
+    EpochDomain::Collect();
+    ASSERT_EQ(alive, 0);
+}
+
+// Constructed before the epoch state of its thread, so destroyed after it
+struct LateRelease {
+    ~LateRelease() {
+        EpochGuard guard;
+        sp.Reset();
+    }
+    SharedPtr<Counted, LockPolicy::kEpoch> sp;
+};
+
+TEST(EpochPolicy, RetireAfterThreadExit) {
+    int alive = 0;
+    std::thread([&alive] {
+        static thread_local LateRelease late;
+        late.sp = MakeShared<Counted, LockPolicy::kEpoch>(&alive);
+        EpochGuard guard;
+    }).join();
+    ASSERT_EQ(alive, 1);
+    EpochDomain::Collect();
+    ASSERT_EQ(alive, 0);
+}
+
+// AllocateShared
+struct AllocatorCalls {
+    int allocations = 0;
+    int deallocations = 0;
+};
+
+template <typename T>
+class CountingAllocator {
+public:
+    using value_type = T;
+
+    explicit CountingAllocator(AllocatorCalls* calls) noexcept : calls_(calls) {
+    }
+
+    template <typename U>
+    explicit CountingAllocator(const CountingAllocator<U>& other) noexcept
+        : calls_(other.calls_) {
+    }
+
+    T* allocate(std::size_t n) {  // NOLINT
+        ++calls_->allocations;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) {  // NOLINT
+        ++calls_->deallocations;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    friend class CountingAllocator;
+
+private:
+    AllocatorCalls* calls_;
+};
+
+TEST(AllocateShared, SingleAllocation) {
+    AllocatorCalls calls;
+    WeakPtr<std::string> w;
+    {
+        auto sp = AllocateShared<std::string>(CountingAllocator<std::string>(&calls), "hello");
+        SharedPtr<std::string> copy = sp;
+        w = copy;
+        ASSERT_EQ(sp.UseCount(), 2);
+        ASSERT_EQ(*w.Lock(), "hello");
+    }
+    // The object is gone, the block stays for the WeakPtr
+    ASSERT_TRUE(w.Expired() && calls.allocations == 1 && calls.deallocations == 0);
+    w.Reset();
+    ASSERT_EQ(calls.deallocations, 1);
+}
+
+TEST(AllocateShared, DestroysObject) {
+    AllocatorCalls calls;
+    int alive = 0;
+    auto sp = AllocateShared<Counted>(CountingAllocator<Counted>(&calls), &alive);
+    ASSERT_EQ(alive, 1);
+    sp.Reset();
+    ASSERT_TRUE(alive == 0 && calls.allocations == 1 && calls.deallocations == 1);
+}
+
+// Aliasing and EnableSharedFromThis reuse the control block of the owner: the
+// counting allocator sees the single allocation made by AllocateShared
+TEST(Aliasing, SharesOwner) {
+    struct Pair {
+        Pair(int* alive, int32_t second) : first(alive), second(second) {
+        }
+
+        Counted first;
+        int32_t second;
+    };
+
+    AllocatorCalls calls;
+    int alive = 0;
+    auto sp = AllocateShared<Pair>(CountingAllocator<Pair>(&calls), &alive, 42);
+    SharedPtr<int32_t> second(sp, &sp->second);
+    SharedPtr<Counted> first(std::move(sp), &sp->first);
+    ASSERT_TRUE(!sp && first.UseCount() == 2 && *second == 42);
+    ASSERT_EQ(calls.allocations, 1);
+
+    first.Reset();
+    ASSERT_TRUE(alive == 1 && *second == 42);
+    second.Reset();
+    ASSERT_TRUE(alive == 0 && calls.deallocations == 1);
+}
+
+TEST(SharedFromThis, Test1) {
+    struct Node : EnableSharedFromThis<Node> {
+        int32_t value = 42;
+    };
+
+    ASSERT_FALSE(Node().SharedFromThis());
+    AllocatorCalls calls;
+    auto sp = AllocateShared<Node>(CountingAllocator<Node>(&calls));
+    SharedPtr<Node> self = sp->SharedFromThis();
+    SharedPtr<const Node> const_self = static_cast<const Node&>(*sp).SharedFromThis();
+    WeakPtr<Node> weak = sp->WeakFromThis();
+    SharedPtr<int32_t> member(sp->SharedFromThis(), &sp->value);
+    ASSERT_TRUE(self.Get() == sp.Get() && const_self.Get() == sp.Get());
+    ASSERT_EQ(sp.UseCount(), 4);
+    ASSERT_EQ(calls.allocations, 1);
+
+    sp.Reset();
+    self.Reset();
+    const_self.Reset();
+    ASSERT_FALSE(weak.Expired());
+    member.Reset();
+    ASSERT_TRUE(weak.Expired());
+    weak.Reset();
+    ASSERT_EQ(calls.deallocations, 1);
+}
+
+TEST(SharedFromThis, Test2) {
+    struct Node : EnableSharedFromThis<Node, LockPolicy::kSingle> {};
+
+    SharedPtr<Node, LockPolicy::kSingle> sp(new Node());
+    SharedPtr<Node, LockPolicy::kSingle> self = sp->SharedFromThis();
+    ASSERT_TRUE(self.Get() == sp.Get() && sp.UseCount() == 2);
+
+    // A copy of the object is not owned by anybody
+    Node copy = *sp;
+    ASSERT_FALSE(copy.SharedFromThis());
+}
+
+// IntrusivePtr
+TEST(IntrusivePtr, Test1) {
+    struct Node : IntrusiveRefCounted<Node> {
+        explicit Node(int* alive) : counted(alive) {
+        }
+
+        Counted counted;
+    };
+
+    static_assert(sizeof(IntrusivePtr<Node>) == sizeof(Node*));
+    int alive = 0;
+    auto p = MakeIntrusive<Node>(&alive);
+    IntrusivePtr<Node> copy = p;
+    IntrusivePtr<Node> again(p.Get());
+    ASSERT_TRUE(copy.Get() == p.Get() && p.UseCount() == 3 && alive == 1);
+
+    IntrusivePtr<Node> moved = std::move(copy);
+    ASSERT_TRUE(!copy && moved.UseCount() == 3);
+    p.Reset();
+    again.Reset();
+    ASSERT_EQ(alive, 1);
+    moved.Reset();
+    ASSERT_EQ(alive, 0);
+}
+
+// A stateless allocator: AllocatorDelete creates its own instance
+AllocatorCalls pool_calls;
+
+template <typename T>
+struct GlobalCountingAllocator {
+    using value_type = T;
+
+    GlobalCountingAllocator() noexcept = default;
+    template <typename U>
+    explicit GlobalCountingAllocator(const GlobalCountingAllocator<U>&) noexcept {
+    }
+
+    T* allocate(std::size_t n) {  // NOLINT
+        ++pool_calls.allocations;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) {  // NOLINT
+        ++pool_calls.deallocations;
+        std::allocator<T>().deallocate(p, n);
+    }
+};
+
+TEST(IntrusivePtr, Test2) {
+    struct Node : IntrusiveRefCounted<Node, LockPolicy::kSingle,
+                                      AllocatorDelete<GlobalCountingAllocator<Node>>> {
+        explicit Node(int* alive) : counted(alive) {
+        }
+
+        Counted counted;
+    };
+
+    int alive = 0;
+    pool_calls = AllocatorCalls();
+    auto p = AllocateIntrusive<Node>(GlobalCountingAllocator<int>(), &alive);
+    IntrusivePtr<Node> copy = p;
+    ASSERT_TRUE(p.UseCount() == 2 && alive == 1 && pool_calls.allocations == 1);
+    p.Reset();
+    copy.Reset();
+    ASSERT_TRUE(alive == 0 && pool_calls.deallocations == 1);
+}
+
+TEST(AtomicSharedPtr, Operations) {
+    AtomicSharedPtr<int32_t> a;
+    ASSERT_FALSE(a.Load());
+
+    auto first = MakeShared<int32_t>(1);
+    a.Store(first);
+    ASSERT_TRUE(a.Load().Get() == first.Get() && first.UseCount() == 3);
+
+    auto second = MakeShared<int32_t>(2);
+    SharedPtr<int32_t> old = a.Exchange(second);
+    ASSERT_TRUE(old.Get() == first.Get() && first.UseCount() == 2);
+
+    SharedPtr<int32_t> expected = first;
+    ASSERT_FALSE(a.CompareExchange(expected, MakeShared<int32_t>(3)));
+    ASSERT_EQ(expected.Get(), second.Get());
+    ASSERT_TRUE(a.CompareExchange(expected, first));
+    ASSERT_EQ(*a.Load(), 1);
+    ASSERT_EQ(second.UseCount(), 2);
+
+    a.Store(SharedPtr<int32_t>());
+    ASSERT_TRUE(!a.Load() && first.UseCount() == 2);
+}
+
+// Readers must always see a consistent snapshot and every replaced one is freed
+TEST(AtomicSharedPtr, ReadersAndWriter) {
+    struct Snapshot {
+        Snapshot(int32_t version, std::atomic<int>* alive)
+            : alive(alive), first(version), second(version) {
+            ++*alive;
+        }
+        ~Snapshot() {
+            --*alive;
+        }
+
+        std::atomic<int>* alive;
+        int32_t first;
+        int32_t second;
+    };
+
+    const int32_t versions = 20000;
+    std::atomic<int> alive{0};
+    {
+        AtomicSharedPtr<Snapshot> a(MakeShared<Snapshot>(0, &alive));
+        std::atomic<bool> done{false};
+        std::atomic<int32_t> torn{0};
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 4; ++i) {
+            readers.emplace_back([&] {
+                int32_t last = 0;
+                while (!done.load()) {
+                    SharedPtr<Snapshot> s = a.Load();
+                    if (s->first != s->second || s->first < last) {
+                        ++torn;
+                    }
+                    last = s->first;
+                }
+            });
+        }
+        for (int32_t version = 1; version <= versions; ++version) {
+            a.Store(MakeShared<Snapshot>(version, &alive));
+        }
+        done = true;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        ASSERT_EQ(torn.load(), 0);
+        ASSERT_EQ(a.Load()->first, versions);
+        ASSERT_EQ(alive.load(), 1);
+    }
+    ASSERT_EQ(alive.load(), 0);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
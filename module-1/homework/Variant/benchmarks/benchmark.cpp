@@ -0,0 +1,199 @@
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "../variant.h"
+#include "benchmark/benchmark.h"
+
+// Adapters over the two implementations, every benchmark runs once for each
+struct Task {
+    template <typename... Types>
+    using Variant = task::Variant<Types...>;
+
+    template <typename T, typename... Types>
+    static const T& Get(Variant<Types...>& variant) {
+        return task::Get<T>(variant);
+    }
+
+    template <typename F, typename... Variants>
+    static decltype(auto) Visit(F&& f, Variants&&... variants) {
+        return task::Visit(std::forward<F>(f), std::forward<Variants>(variants)...);
+    }
+};
+
+struct Std {
+    template <typename... Types>
+    using Variant = std::variant<Types...>;
+
+    template <typename T, typename... Types>
+    static const T& Get(Variant<Types...>& variant) {
+        return std::get<T>(variant);
+    }
+
+    template <typename F, typename... Variants>
+    static decltype(auto) Visit(F&& f, Variants&&... variants) {
+        return std::visit(std::forward<F>(f), std::forward<Variants>(variants)...);
+    }
+};
+
+template <typename Impl>
+void AssignGet(benchmark::State& state) {
+    typename Impl::template Variant<int64_t, double, std::string> variant;
+    for (auto _ : state) {
+        variant = int64_t{42};
+        benchmark::DoNotOptimize(Impl::template Get<int64_t>(variant));
+        variant = 4.2;
+        benchmark::DoNotOptimize(Impl::template Get<double>(variant));
+        variant = std::string("hello");
+        benchmark::DoNotOptimize(Impl::template Get<std::string>(variant).size());
+    }
+}
+
+// Reassigning one alternative: no destruction of another one in between
+template <typename Impl>
+void AssignSame(benchmark::State& state) {
+    typename Impl::template Variant<int64_t, double, std::string> variant;
+    int64_t value = 0;
+    for (auto _ : state) {
+        variant = value++;
+        benchmark::DoNotOptimize(Impl::template Get<int64_t>(variant));
+    }
+}
+
+template <typename Impl>
+void Traverse(benchmark::State& state) {
+    std::vector<typename Impl::template Variant<int64_t, double>> values(
+        static_cast<std::size_t>(state.range(0)));
+    for (std::size_t i = 0; i < values.size(); i++) {
+        values[i] = static_cast<int64_t>(i);
+    }
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (auto& value : values) {
+            sum += Impl::template Get<int64_t>(value);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Nine bytes of data in sixteen: the index follows the whole Packet, which may
+// be written with all of its padding
+struct Packet {
+    explicit Packet(int64_t id) : id(id), flags(0) {
+    }
+    int64_t id;
+    uint8_t flags;
+};
+
+// Growth without reserve: a trivially copyable variant is relocated by memcpy
+template <typename Impl>
+void VectorGrowth(benchmark::State& state) {
+    using Variant = typename Impl::template Variant<int64_t, double, Packet>;
+    for (auto _ : state) {
+        std::vector<Variant> values;
+        for (int64_t i = 0; i < state.range(0); i++) {
+            values.push_back(Packet(i));
+        }
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["variant_bytes"] = sizeof(Variant);
+}
+
+template <typename Impl>
+void VectorCopy(benchmark::State& state) {
+    using Variant = typename Impl::template Variant<int64_t, double, Packet>;
+    std::vector<Variant> values(static_cast<std::size_t>(state.range(0)), Packet(0));
+    for (auto _ : state) {
+        std::vector<Variant> copy = values;
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) *
+                            static_cast<int64_t>(sizeof(Variant)));
+    state.counters["variant_bytes"] = sizeof(Variant);
+}
+
+// Distinct alternatives of the same size, the visitor result depends on the type
+template <std::size_t I>
+struct Tag {
+    int64_t value;
+};
+
+template <typename Impl, typename Indexes>
+struct Alternatives;
+
+template <typename Impl, std::size_t... Is>
+struct Alternatives<Impl, std::index_sequence<Is...>> {
+    using Variant = typename Impl::template Variant<Tag<Is>...>;
+
+    static std::vector<Variant> Mixed(std::size_t size) {
+        const Variant values_of[] = {Tag<Is>{static_cast<int64_t>(Is)}...};
+        std::vector<Variant> values;
+        values.reserve(size);
+        // A stride coprime with the count keeps the branch predictor guessing
+        for (std::size_t i = 0; i < size; i++) {
+            values.push_back(values_of[(i * 7 + i / 3) % sizeof...(Is)]);
+        }
+        return values;
+    }
+};
+
+// Visit of one variant with N alternatives: dispatch on an unpredictable index
+template <typename Impl, std::size_t N>
+void Visit(benchmark::State& state) {
+    using Types = Alternatives<Impl, std::make_index_sequence<N>>;
+    auto values = Types::Mixed(1 << 12);
+    auto weight = [](const auto& tag) { return tag.value * static_cast<int64_t>(sizeof(tag)); };
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (const auto& value : values) {
+            sum += Impl::Visit(weight, value);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(values.size()));
+}
+
+// Visit of two variants: N * N combinations
+template <typename Impl, std::size_t N>
+void VisitPair(benchmark::State& state) {
+    using Types = Alternatives<Impl, std::make_index_sequence<N>>;
+    auto lhs = Types::Mixed(1 << 12);
+    auto rhs = Types::Mixed((1 << 12) + 1);
+    auto product = [](const auto& a, const auto& b) { return a.value * b.value; };
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (std::size_t i = 0; i < lhs.size(); i++) {
+            sum += Impl::Visit(product, lhs[i], rhs[i + 1]);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(lhs.size()));
+}
+
+BENCHMARK_TEMPLATE(AssignGet, Task);
+BENCHMARK_TEMPLATE(AssignGet, Std);
+BENCHMARK_TEMPLATE(AssignSame, Task);
+BENCHMARK_TEMPLATE(AssignSame, Std);
+BENCHMARK_TEMPLATE(Traverse, Task)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(Traverse, Std)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_TEMPLATE(VectorGrowth, Task)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(VectorGrowth, Std)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(VectorCopy, Task)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(VectorCopy, Std)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(Visit, Task, 2);
+BENCHMARK_TEMPLATE(Visit, Std, 2);
+BENCHMARK_TEMPLATE(Visit, Task, 8);
+BENCHMARK_TEMPLATE(Visit, Std, 8);
+BENCHMARK_TEMPLATE(Visit, Task, 32);
+BENCHMARK_TEMPLATE(Visit, Std, 32);
+BENCHMARK_TEMPLATE(VisitPair, Task, 2);
+BENCHMARK_TEMPLATE(VisitPair, Std, 2);
+BENCHMARK_TEMPLATE(VisitPair, Task, 8);
+BENCHMARK_TEMPLATE(VisitPair, Std, 8);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,37 @@
+// Translation unit of the compile_time target: a Variant of ALTERNATIVES
+// distinct types, every one of them is assigned, read and visited
+#include <cstddef>
+#include <utility>
+
+#include "../variant.h"
+
+#ifndef ALTERNATIVES
+#define ALTERNATIVES 10
+#endif
+
+template <std::size_t I>
+struct Message {
+    std::size_t id = I;
+};
+
+template <typename Indexes>
+struct Protocol;
+
+template <std::size_t... Is>
+struct Protocol<std::index_sequence<Is...>> {
+    using Variant = task::Variant<Message<Is>...>;
+
+    static std::size_t Touch() {
+        Variant message;
+        std::size_t sum = 0;
+        ((message = Message<Is>(), sum += Get<Message<Is>>(message).id + Get<Is>(message).id +
+                                          HoldsAlternative<Message<Is>>(message)),
+         ...);
+        Variant copy = message;
+        return sum + Visit([](const auto& m) { return m.id; }, copy);
+    }
+};
+
+std::size_t Touch() {
+    return Protocol<std::make_index_sequence<ALTERNATIVES>>::Touch();
+}
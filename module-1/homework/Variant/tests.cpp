@@ -1,5 +1,9 @@
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <type_traits>
 
 #include "gtest/gtest.h"
 #include "variant.h"
@@ -28,6 +32,121 @@ TEST(Get, Test4) {
     ASSERT_NEAR(Get<1>(v), 12.0, 1e-5);
 }
 
+TEST(Variant, CopyMove) {
+    task::Variant<int32_t, std::string> v = std::string("Hello world");
+    task::Variant<int32_t, std::string> copy = v;
+    task::Variant<int32_t, std::string> moved = std::move(v);
+    ASSERT_TRUE(copy.Index() == 1 && Get<std::string>(moved) == "Hello world");
+
+    copy = 42;
+    moved = copy;
+    ASSERT_TRUE(HoldsAlternative<int32_t>(moved) && Get<0>(moved) == 42);
+    ASSERT_THROW(Get<std::string>(moved), task::BadVariantAccess);
+}
+
+// The index takes the smallest type and the tail padding of the storage, which
+// lies past every alternative
+TEST(Variant, Layout) {
+    struct Padded {
+        explicit Padded(int64_t v) : value(v), tag('p') {
+        }
+        int64_t value;
+        char tag;
+    };
+    struct Five {
+        char bytes[5];
+    };
+    static_assert(sizeof(task::Variant<int8_t, char>) == 2);
+    static_assert(sizeof(task::Variant<int32_t, float>) == 8);
+    static_assert(sizeof(task::Variant<int32_t, Five>) == 8);
+    static_assert(sizeof(task::Variant<int64_t, Padded>) == sizeof(Padded) + alignof(Padded));
+    static_assert(std::is_trivially_copyable_v<task::Variant<int32_t, double, Padded>>);
+    static_assert(std::is_trivially_destructible_v<task::Variant<int32_t, double, Padded>>);
+    static_assert(!std::is_trivially_copyable_v<task::Variant<int32_t, std::string>>);
+
+    // Assigning the alternative must not overwrite the index in its padding
+    task::Variant<int64_t, Padded> v = Padded(1);
+    task::Variant<int64_t, Padded> copy = v;
+    v = Padded(2);
+    ASSERT_TRUE(v.Index() == 1 && Get<Padded>(v).value == 2 && Get<Padded>(v).tag == 'p');
+    v = copy;
+    ASSERT_TRUE(v.Index() == 1 && Get<Padded>(v).value == 1);
+    v = int64_t{3};
+    ASSERT_TRUE(v.Index() == 0 && Get<int64_t>(v) == 3);
+}
+
+// memcpy and std::copy write the padding of the alternative too. The
+// constructor makes Padded a non-POD, whose tail padding could be reused
+TEST(Variant, FullWrites) {
+    struct Padded {
+        Padded(int64_t v, char t) : value(v), tag(t) {
+        }
+        int64_t value;
+        char tag;
+    };
+    static_assert(std::is_trivially_copyable_v<Padded>);
+
+    for (int fill : {0x00, 0xff}) {
+        Padded source(0, 0);
+        std::memset(static_cast<void*>(&source), fill, sizeof(source));
+        source.value = 2;
+        source.tag = 'q';
+
+        task::Variant<int32_t, Padded> v = Padded(1, 'p');
+        auto write = [&source](auto& x) {
+            if constexpr (std::is_same_v<std::remove_cvref_t<decltype(x)>, Padded>) {
+                std::memcpy(&x, &source, sizeof(source));
+            }
+        };
+        Visit(write, v);
+        ASSERT_TRUE(v.Index() == 1 && Get<Padded>(v).value == 2);
+
+        auto copy = [&source](auto& x) {
+            if constexpr (std::is_same_v<std::remove_cvref_t<decltype(x)>, Padded>) {
+                std::copy(&source, &source + 1, &x);
+            }
+        };
+        v = Padded(3, 'p');
+        Visit(copy, v);
+        ASSERT_TRUE(v.Index() == 1 && Get<Padded>(v).tag == 'q');
+    }
+}
+
+TEST(Visit, Test1) {
+    task::Variant<int32_t, double, std::string> v = 12.0;
+    auto name = [](const auto& value) -> std::string {
+        if constexpr (std::is_same_v<std::decay_t<decltype(value)>, std::string>) {
+            return value;
+        } else {
+            return std::to_string(static_cast<int32_t>(value));
+        }
+    };
+    ASSERT_EQ(Visit(name, v), "12");
+    v = "Hello world";
+    ASSERT_EQ(Visit(name, v), "Hello world");
+
+    // Alternatives are passed by reference
+    Visit([](auto& value) { value = value + value; }, v);
+    ASSERT_EQ(Get<std::string>(v), "Hello worldHello world");
+}
+
+// Every pair of alternatives of two variants reaches its own entry of the table
+TEST(Visit, MultipleVariants) {
+    using Small = task::Variant<int8_t, int16_t, int32_t>;
+    using Large = task::Variant<char, int32_t, int64_t, float, double>;
+    auto sizes = [](auto lhs, auto rhs) { return sizeof(lhs) * 10 + sizeof(rhs); };
+    Small small = int16_t{1};
+    Large large = 1.0f;
+    ASSERT_EQ(Visit(sizes, small, large), 24U);
+    small = int32_t{1};
+    large = int64_t{1};
+    ASSERT_EQ(Visit(sizes, small, large), 48U);
+    auto three = [](auto a, auto b, auto c) {
+        return sizeof(a) * 100 + sizeof(b) * 10 + sizeof(c);
+    };
+    ASSERT_EQ(Visit(three, large, small, small), 844U);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
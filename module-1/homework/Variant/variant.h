@@ -1,4 +1,12 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <cstdlib>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
 
 #pragma once
@@ -14,35 +22,479 @@ struct VariantAlternative;
 template <size_t Idx, typename T>
 using variant_alternative_t = typename VariantAlternative<Idx, T>::type;
 
+namespace detail {
+
+// Type Types[I] without recursion: overload resolution finds the only base
+// Indexed<I, T> of Indexer, which is instantiated once per Types
+template <size_t I, typename T>
+struct Indexed {
+    using type = T;
+};
+
+template <typename Indexes, typename... Types>
+struct Indexer;
+
+template <size_t... Is, typename... Types>
+struct Indexer<std::index_sequence<Is...>, Types...> : Indexed<Is, Types>... {};
+
+template <size_t I, typename T>
+Indexed<I, T> SelectIndexed(const Indexed<I, T>&);
+
+template <size_t I, typename... Types>
+using TypeAt = typename decltype(SelectIndexed<I>(
+    std::declval<Indexer<std::index_sequence_for<Types...>, Types...>>()))::type;
+
+}  // namespace detail
+
 template <size_t Idx, typename... Types>
 struct VariantAlternative<Idx, Variant<Types...>> {
-  using type =  // Your code goes here
+    using type = detail::TypeAt<Idx, Types...>;
+};
+
+template <typename T>
+struct VariantSize;
+
+template <typename... Types>
+struct VariantSize<Variant<Types...>> : std::integral_constant<size_t, sizeof...(Types)> {};
+
+template <typename T>
+inline constexpr size_t variant_size_v = VariantSize<std::remove_cvref_t<T>>::value;
+
+// Index of a Variant left without a value by a throwing assignment
+inline constexpr size_t kVariantNpos = static_cast<size_t>(-1);
+
+class BadVariantAccess : public std::exception {
+public:
+    const char* what() const noexcept override {
+        return "bad variant access";
+    }
+};
+
+namespace detail {
+
+// Smallest unsigned type holding the indexes of N alternatives and the npos
+// value, its maximum
+template <size_t N>
+using IndexType =
+    std::conditional_t<(N < UINT8_MAX), uint8_t,
+                       std::conditional_t<(N < UINT16_MAX), uint16_t, uint32_t>>;
+
+// One flat buffer for all alternatives instead of a union nested once per
+// alternative. It holds sizeof(T) bytes of the largest one, since a complete T
+// may be written whole, by memcpy as well. The constructor makes it a non-POD:
+// the index goes into its tail padding, which lies past every alternative, if
+// the largest size is not a multiple of the strictest alignment
+template <typename... Types>
+struct Storage {
+    Storage() noexcept {
+    }
+
+    alignas(Types...) unsigned char bytes[std::max({sizeof(Types)...})];
+};
+
+// T with the reference kind of From
+template <typename From, typename T>
+using CopyReference =
+    std::conditional_t<std::is_lvalue_reference_v<From>, T&, std::remove_reference_t<T>&&>;
+
+struct Access {
+    // The alternative I of v, which must hold it, with the value category of v
+    template <size_t I, typename V>
+    static decltype(auto) Get(V&& v) noexcept {
+        using Alternative = variant_alternative_t<I, std::remove_cvref_t<V>>;
+        using T = std::conditional_t<std::is_const_v<std::remove_reference_t<V>>,
+                                     const Alternative, Alternative>;
+        T* alternative = reinterpret_cast<T*>(&v.storage_);
+        // No std::launder for trivially copyable types, as in libstdc++: GCC
+        // does not merge identical Visit cases through it. For the others it
+        // also spares a false -Wmaybe-uninitialized
+        if constexpr (!std::is_trivially_copyable_v<Alternative>) {
+            alternative = std::launder(alternative);
+        }
+        return static_cast<CopyReference<V&&, T>>(*alternative);
+    }
+
+    // Starts the lifetime of the alternative I in v, the previous one is over
+    template <size_t I, typename V, typename... Args>
+    static void Construct(V& v, Args&&... args) {
+        using T = variant_alternative_t<I, V>;
+        ::new (static_cast<void*>(&v.storage_)) T(std::forward<Args>(args)...);
+    }
+};
+
+// Index of T in Types, sizeof...(Types) if it is absent or not unique
+template <typename T, typename... Types>
+constexpr size_t FindExactlyOne() {
+    constexpr bool kFound[] = {std::is_same_v<T, Types>...};
+    size_t result = sizeof...(Types);
+    for (size_t i = 0; i < sizeof...(Types); i++) {
+        if (kFound[i]) {
+            if (result != sizeof...(Types)) {
+                return sizeof...(Types);
+            }
+            result = i;
+        }
+    }
+    return result;
+}
+
+// The alternative chosen by the converting constructor and assignment: the
+// best overload of F(T_i) over the T_i which U converts to without narrowing
+template <size_t I, typename T>
+struct Candidate {
+    template <typename U>
+    requires requires(U&& u) {
+        std::type_identity_t<T[]>{std::forward<U>(u)};
+    }
+    std::integral_constant<size_t, I> operator()(T, U&&) const;
+};
+
+template <typename Indexes, typename... Types>
+struct Selector;
+
+template <size_t... I, typename... Types>
+struct Selector<std::index_sequence<I...>, Types...> : Candidate<I, Types>... {
+    using Candidate<I, Types>::operator()...;
+};
+
+template <typename U, typename... Types>
+using SelectedIndex = decltype(Selector<std::index_sequence_for<Types...>, Types...>()(
+    std::declval<U>(), std::declval<U>()));
+
+// Converting constructor and assignment of V accept U which selects exactly
+// one alternative, never V itself
+template <typename U, typename V, typename... Types>
+concept Converting = !std::is_same_v<std::remove_cvref_t<U>, V> && requires {
+    typename SelectedIndex<U, Types...>;
+};
+
+// Calls f(std::integral_constant<size_t, I>()...) for the indexes encoded in
+// flat, the row-major position in a Sizes[0] x Sizes[1] x ... grid. Small
+// grids compile to a switch, the others go through one table of function
+// pointers built at compile time: O(1) either way
+template <typename R, size_t... Sizes>
+class IndexDispatch {
+    static constexpr size_t kSizes[] = {Sizes...};
+    static constexpr size_t kTotal = (Sizes * ... * 1);
+    static constexpr size_t kSwitchCases = 8;
+
+public:
+    template <typename... Indexes>
+    static constexpr size_t Flatten(Indexes... indexes) noexcept {
+        size_t flat = 0;
+        size_t k = 0;
+        ((flat = flat * kSizes[k++] + indexes), ...);
+        return flat;
+    }
+
+    template <typename F>
+    static constexpr R Call(F& f, size_t flat) {
+        if constexpr (kTotal <= kSwitchCases) {
+            switch (flat) {
+                case 0:
+                    return Case<0>(f);
+                case 1:
+                    return Case<1>(f);
+                case 2:
+                    return Case<2>(f);
+                case 3:
+                    return Case<3>(f);
+                case 4:
+                    return Case<4>(f);
+                case 5:
+                    return Case<5>(f);
+                case 6:
+                    return Case<6>(f);
+                default:
+                    return Case<7>(f);
+            }
+        } else {
+            return kTable<F>[flat](f);
+        }
+    }
+
+private:
+    static constexpr size_t Digit(size_t flat, size_t k) noexcept {
+        for (size_t next = k + 1; next < sizeof...(Sizes); next++) {
+            flat /= kSizes[next];
+        }
+        return flat % kSizes[k];
+    }
+
+    template <size_t Flat, typename F, size_t... K>
+    static constexpr R Invoke(F& f, std::index_sequence<K...>) {
+        return f(std::integral_constant<size_t, Digit(Flat, K)>()...);
+    }
+
+    template <size_t Flat, typename F>
+    static constexpr R Entry(F& f) {
+        return Invoke<Flat>(f, std::make_index_sequence<sizeof...(Sizes)>());
+    }
+
+    template <size_t Flat, typename F>
+    static constexpr R Case(F& f) {
+        if constexpr (Flat < kTotal) {
+            return Entry<Flat>(f);
+        } else {
+            __builtin_unreachable();
+        }
+    }
+
+    template <typename F, size_t... Flat>
+    static constexpr auto MakeTable(std::index_sequence<Flat...>) noexcept {
+        return std::array<R (*)(F&), kTotal>{&Entry<Flat, F>...};
+    }
+
+    template <typename F>
+    static constexpr auto kTable = MakeTable<F>(std::make_index_sequence<kTotal>());
 };
 
+}  // namespace detail
+
 template <typename... Types>
 class Variant {
+    static_assert(sizeof...(Types) > 0, "Variant needs at least one alternative");
+
+    template <typename T>
+    static constexpr size_t kIndexOf = detail::FindExactlyOne<T, Types...>();
+
+    template <size_t I>
+    using Alternative = variant_alternative_t<I, Variant>;
+
+    template <typename T>
+    static constexpr size_t kSelected = detail::SelectedIndex<T, Types...>::value;
+
+    // Emplace builds such alternatives aside, so Visit needs no valueless check
+    static constexpr bool kNeverValueless =
+        ((std::is_trivially_copyable_v<Types> && std::is_nothrow_move_constructible_v<Types>)&&...);
+
+    // Special members that are trivial for all alternatives are trivial for
+    // Variant too, so containers copy it with memcpy
+    static constexpr bool kTrivialCopy = (std::is_trivially_copy_constructible_v<Types> && ...);
+    static constexpr bool kTrivialMove = (std::is_trivially_move_constructible_v<Types> && ...);
+    static constexpr bool kTrivialDestructor = (std::is_trivially_destructible_v<Types> && ...);
+    static constexpr bool kTrivialCopyAssign =
+        kTrivialCopy && kTrivialDestructor && (std::is_trivially_copy_assignable_v<Types> && ...);
+    static constexpr bool kTrivialMoveAssign =
+        kTrivialMove && kTrivialDestructor && (std::is_trivially_move_assignable_v<Types> && ...);
+
+    using IndexType = detail::IndexType<sizeof...(Types)>;
+    static constexpr IndexType kNpos = static_cast<IndexType>(kVariantNpos);
+
 public:
     // Special member functions
-    constexpr Variant() noexcept;
+    Variant() noexcept(std::is_nothrow_default_constructible_v<Alternative<0>>) requires
+        std::is_default_constructible_v<Alternative<0>> {
+        Construct<0>();
+    }
+
+    Variant(const Variant& other) requires kTrivialCopy = default;
+    Variant(const Variant& other);
+    Variant(Variant&& other) requires kTrivialMove = default;
+    Variant(Variant&& other) noexcept((std::is_nothrow_move_constructible_v<Types> && ...));
+
+    template <typename T>
+    requires detail::Converting<T, Variant, Types...> Variant(T&& t)  // NOLINT
+        noexcept(std::is_nothrow_constructible_v<Alternative<kSelected<T>>, T>) {
+        Construct<kSelected<T>>(std::forward<T>(t));
+    }
+
+    ~Variant() requires kTrivialDestructor = default;
+    ~Variant() {
+        Reset();
+    }
+
+    Variant& operator=(const Variant& other) requires kTrivialCopyAssign = default;
+    Variant& operator=(const Variant& other);
+    Variant& operator=(Variant&& other) requires kTrivialMoveAssign = default;
+    Variant& operator=(Variant&& other) noexcept(
+        ((std::is_nothrow_move_constructible_v<Types> &&
+          std::is_nothrow_move_assignable_v<Types>)&&...));
 
     template <typename T>
-    Variant& operator=(T&& t) noexcept;
+    requires detail::Converting<T, Variant, Types...> Variant& operator=(T&& t) noexcept(
+        std::is_nothrow_assignable_v<Alternative<kSelected<T>>&, T>&&
+            std::is_nothrow_constructible_v<Alternative<kSelected<T>>, T>) {
+        constexpr size_t kIndex = kSelected<T>;
+        if (index_ == kIndex) {
+            detail::Access::Get<kIndex>(*this) = std::forward<T>(t);
+        } else {
+            Emplace<kIndex>(std::forward<T>(t));
+        }
+        return *this;
+    }
+
+    // Modifiers
+    template <size_t I, typename... Args>
+    Alternative<I>& Emplace(Args&&... args) {
+        if constexpr (kNeverValueless &&
+                      !std::is_nothrow_constructible_v<Alternative<I>, Args...>) {
+            Alternative<I> value(std::forward<Args>(args)...);
+            Reset();
+            Construct<I>(std::move(value));
+        } else {
+            Reset();
+            Construct<I>(std::forward<Args>(args)...);
+        }
+        return detail::Access::Get<I>(*this);
+    }
+
+    template <typename T, typename... Args>
+    T& Emplace(Args&&... args) {
+        static_assert(kIndexOf<T> < sizeof...(Types), "T must occur exactly once in Types");
+        return Emplace<kIndexOf<T>>(std::forward<Args>(args)...);
+    }
+
+    // Observers
+    // kNpos wraps to 0 and becomes kVariantNpos without a branch
+    constexpr size_t Index() const noexcept {
+        if constexpr (kNeverValueless) {
+            return index_;
+        } else {
+            return static_cast<size_t>(static_cast<IndexType>(index_ + 1)) - 1;
+        }
+    }
+
+    constexpr bool ValuelessByException() const noexcept {
+        return !kNeverValueless && index_ == kNpos;
+    }
+
+    friend struct detail::Access;
 
 private:
-    // Your code goes here
+    using Dispatch = detail::IndexDispatch<void, sizeof...(Types)>;
+
+    template <size_t I, typename... Args>
+    void Construct(Args&&... args) {
+        detail::Access::Construct<I>(*this, std::forward<Args>(args)...);
+        index_ = static_cast<IndexType>(I);
+    }
+
+    void Reset() noexcept {
+        if (index_ != kNpos) {
+            auto destroy = [this](auto i) {
+                std::destroy_at(&detail::Access::Get<i>(*this));
+            };
+            Dispatch::Call(destroy, index_);
+            index_ = kNpos;
+        }
+    }
+
+    // The index may only take padding past sizeof of every alternative: a
+    // reference from Get or Visit may be written whole, padding included
+    [[no_unique_address]] detail::Storage<Types...> storage_;
+    IndexType index_ = kNpos;
 };
 
+template <typename... Types>
+Variant<Types...>::Variant(const Variant& other) {
+    if (!other.ValuelessByException()) {
+        auto copy = [this, &other](auto i) { Construct<i>(detail::Access::Get<i>(other)); };
+        Dispatch::Call(copy, other.index_);
+    }
+}
+
+template <typename... Types>
+Variant<Types...>::Variant(Variant&& other) noexcept(
+    (std::is_nothrow_move_constructible_v<Types> && ...)) {
+    if (!other.ValuelessByException()) {
+        auto move = [this, &other](auto i) {
+            Construct<i>(detail::Access::Get<i>(std::move(other)));
+        };
+        Dispatch::Call(move, other.index_);
+    }
+}
+
+template <typename... Types>
+Variant<Types...>& Variant<Types...>::operator=(const Variant& other) {
+    if (other.ValuelessByException()) {
+        Reset();
+    } else if (this != &other) {
+        auto assign = [this, &other](auto i) {
+            if (index_ == i) {
+                detail::Access::Get<i>(*this) = detail::Access::Get<i>(other);
+            } else {
+                Emplace<i>(detail::Access::Get<i>(other));
+            }
+        };
+        Dispatch::Call(assign, other.index_);
+    }
+    return *this;
+}
+
+template <typename... Types>
+Variant<Types...>& Variant<Types...>::operator=(Variant&& other) noexcept(
+    ((std::is_nothrow_move_constructible_v<Types> &&
+      std::is_nothrow_move_assignable_v<Types>)&&...)) {
+    if (other.ValuelessByException()) {
+        Reset();
+    } else if (this != &other) {
+        auto assign = [this, &other](auto i) {
+            if (index_ == i) {
+                detail::Access::Get<i>(*this) = detail::Access::Get<i>(std::move(other));
+            } else {
+                Emplace<i>(detail::Access::Get<i>(std::move(other)));
+            }
+        };
+        Dispatch::Call(assign, other.index_);
+    }
+    return *this;
+}
+
 // Non-member functions
+template <typename T, typename... Types>
+constexpr bool HoldsAlternative(const Variant<Types...>& v) noexcept {
+    constexpr size_t kIndex = detail::FindExactlyOne<T, Types...>();
+    static_assert(kIndex < sizeof...(Types), "T must occur exactly once in Types");
+    return v.Index() == kIndex;
+}
+
 template <size_t I, typename... Types>
-constexpr const variant_alternative_t<I, Variant<Types...>>& Get(Variant<Types...>& v);
+constexpr const variant_alternative_t<I, Variant<Types...>>& Get(Variant<Types...>& v) {
+    if (v.Index() != I) {
+        throw BadVariantAccess();
+    }
+    return detail::Access::Get<I>(v);
+}
 
 template <size_t I, typename... Types>
-constexpr variant_alternative_t<I, Variant<Types...>>&& Get(Variant<Types...>&& v);
+constexpr variant_alternative_t<I, Variant<Types...>>&& Get(Variant<Types...>&& v) {
+    if (v.Index() != I) {
+        throw BadVariantAccess();
+    }
+    return detail::Access::Get<I>(std::move(v));
+}
 
 template <typename T, typename... Types>
-constexpr const T& Get(Variant<Types...>& v);
+constexpr const T& Get(Variant<Types...>& v) {
+    constexpr size_t kIndex = detail::FindExactlyOne<T, Types...>();
+    static_assert(kIndex < sizeof...(Types), "T must occur exactly once in Types");
+    return Get<kIndex>(v);
+}
 
 template <typename T, typename... Types>
-constexpr T&& Get(Variant<Types...>&& v);
+constexpr T&& Get(Variant<Types...>&& v) {
+    constexpr size_t kIndex = detail::FindExactlyOne<T, Types...>();
+    static_assert(kIndex < sizeof...(Types), "T must occur exactly once in Types");
+    return Get<kIndex>(std::move(v));
+}
+
+// Calls f with the current alternatives of all variants, which keep their
+// value category. Every combination must return the same type
+template <typename F, typename... Variants>
+constexpr decltype(auto) Visit(F&& f, Variants&&... variants) {
+    if ((variants.ValuelessByException() || ...)) {
+        throw BadVariantAccess();
+    }
+    using R = decltype(std::invoke(std::forward<F>(f),
+                                   detail::Access::Get<0>(std::forward<Variants>(variants))...));
+    using Dispatch = detail::IndexDispatch<R, variant_size_v<Variants>...>;
+
+    auto call = [&f, &variants...](auto... i) -> R {
+        return std::invoke(std::forward<F>(f),
+                           detail::Access::Get<i>(std::forward<Variants>(variants))...);
+    };
+    return Dispatch::Call(call, Dispatch::Flatten(variants.Index()...));
+}
 
-};  // namespace task
\ No newline at end of file
+};  // namespace task
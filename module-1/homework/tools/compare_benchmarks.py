@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+"""Сравнение двух JSON-отчетов google-benchmark.
+
+    python3 compare_benchmarks.py old.json new.json [--threshold 0.05]
+
+Для каждого бенчмарка, присутствующего в обоих отчетах, печатает время до и
+после и их отношение. Код возврата 1, если хотя бы один бенчмарк замедлился
+больше чем на threshold.
+"""
+
+import argparse
+import json
+import sys
+
+TO_NANOSECONDS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load(path, metric):
+    with open(path) as report:
+        benchmarks = json.load(report)["benchmarks"]
+    times = {}
+    for benchmark in benchmarks:
+        # Повторы (--benchmark_repetitions) сравниваются по медиане
+        if benchmark.get("run_type") == "aggregate":
+            if benchmark.get("aggregate_name") != "median":
+                continue
+            name = benchmark["run_name"]
+        else:
+            name = benchmark["name"]
+        unit = TO_NANOSECONDS[benchmark.get("time_unit", "ns")]
+        times[name] = benchmark[metric] * unit
+    return times
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("old")
+    parser.add_argument("new")
+    parser.add_argument("--metric", choices=["real_time", "cpu_time"], default="real_time")
+    parser.add_argument("--threshold", type=float, default=0.05,
+                        help="допустимое относительное замедление")
+    args = parser.parse_args()
+
+    old = load(args.old, args.metric)
+    new = load(args.new, args.metric)
+
+    regressions = 0
+    width = max((len(name) for name in old if name in new), default=0)
+    for name in old:
+        if name not in new:
+            continue
+        ratio = new[name] / old[name] if old[name] else float("inf")
+        mark = ""
+        if ratio > 1 + args.threshold:
+            mark = "  REGRESSION"
+            regressions += 1
+        elif ratio < 1 - args.threshold:
+            mark = "  improvement"
+        print("{:<{}}  {:>14.1f} ns  {:>14.1f} ns  {:>6.3f}x{}".format(
+            name, width, old[name], new[name], ratio, mark))
+
+    for name in sorted(set(old) ^ set(new)):
+        print("{}: only in {}".format(name, args.old if name in old else args.new))
+
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,33 +1,96 @@
 #include "allocator.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <new>
+
+MonotonicArena::MonotonicArena(std::size_t initial_size) :
+    next_size(initial_size)
+{
+}
+
+MonotonicArena::~MonotonicArena()
+{
+    Release();
+}
+
+void* MonotonicArena::allocate(std::size_t bytes, std::size_t alignment) {
+    std::uintptr_t aligned = (reinterpret_cast<std::uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1);
+    if (cursor == nullptr || aligned + bytes > reinterpret_cast<std::uintptr_t>(end)) {
+        // заголовок блока занимает начало памяти, данные идут с выравниванием max_align_t
+        const std::size_t header = (sizeof(Block) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+        std::size_t size = std::max(next_size, header + bytes + alignment);
+        next_size = size * 2;
+
+        Block* block = static_cast<Block*>(::operator new(size));
+        block->next = blocks;
+        block->size = size;
+        blocks = block;
+
+        cursor = reinterpret_cast<char*>(block) + header;
+        end = reinterpret_cast<char*>(block) + size;
+        aligned = (reinterpret_cast<std::uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1);
+    }
+    cursor = reinterpret_cast<char*>(aligned + bytes);
+    return reinterpret_cast<void*>(aligned);
+}
+
+void MonotonicArena::Release() {
+    // next_size не сбрасываем: следующий запрос сразу получит блок подходящего размера
+    while (blocks) {
+        Block* next = blocks->next;
+        ::operator delete(blocks);
+        blocks = next;
+    }
+    cursor = nullptr;
+    end = nullptr;
+}
+
 template<typename T>
-SimpleAllocator<T>::SimpleAllocator() {
-    arena = ::operator new(2000 * sizeof(T));
+SimpleAllocator<T>::SimpleAllocator() :
+    arena(new MonotonicArena(2000 * sizeof(T)))
+{
 }
 
 template<typename T>
 SimpleAllocator<T>::SimpleAllocator(const SimpleAllocator& other) noexcept :
     arena(other.arena)
 {
+    arena->num_allocators++;
 }
 
 template<typename T>
 template<typename U>
-SimpleAllocator<T>::SimpleAllocator(const SimpleAllocator<U>& other) noexcept : 
+SimpleAllocator<T>::SimpleAllocator(const SimpleAllocator<U>& other) noexcept :
     arena(other.arena)
 {
+    arena->num_allocators++;
+}
+
+template<typename T>
+SimpleAllocator<T>& SimpleAllocator<T>::operator=(const SimpleAllocator& other) noexcept {
+    other.arena->num_allocators++;
+    detach();
+    arena = other.arena;
+    return *this;
 }
 
 template<typename T>
 SimpleAllocator<T>::~SimpleAllocator()
 {
-    num_allocators--;
-    if (num_allocators) {
+    detach();
+}
+
+template<typename T>
+void SimpleAllocator<T>::detach() noexcept {
+    // последний аллокатор, разделяющий арену, освобождает ее
+    arena->num_allocators--;
+    if (arena->num_allocators == 0) {
         delete arena;
     }
 }
 
-
 template<typename T>
 SimpleAllocator<T> SimpleAllocator<T>::select_on_container_copy_construction() const {
     return SimpleAllocator();
@@ -35,38 +98,59 @@ SimpleAllocator<T> SimpleAllocator<T>::select_on_container_copy_construction() c
 
 template<typename T>
 T* SimpleAllocator<T>::allocate(std::size_t n) {
-    return ::operator new(n * sizeof(T));
+    return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+}
+
+template<typename T>
+void SimpleAllocator<T>::deallocate(T* p, std::size_t n) {
+    // monotonic: память отдельных узлов не переиспользуется, ее забирает Release()
 }
 
 template<typename T>
-void SimpleAllocator<T>::deallocate(void* p, std::size_t n) {
-    ::operator delete(p);
+void SimpleAllocator<T>::Release() {
+    arena->Release();
 }
 
 template<typename T, typename U>
 bool operator==(const SimpleAllocator<T>& lhs, const SimpleAllocator<U>& rhs) noexcept {
-    return true;
+    return lhs.arena == rhs.arena;
 }
 
 template<typename T, typename U>
 bool operator!=(const SimpleAllocator<T>& lhs, const SimpleAllocator<U>& rhs) noexcept {
-    return true;
+    return !(lhs == rhs);
 }
 
 template<typename T>
-template<typename... Args>
-void SimpleAllocator<T>::construct(void* p, Args&&... args) {
-    // new(p) - это new expression (конкретнее placement new expression),  
+template<typename U, typename... Args>
+void SimpleAllocator<T>::construct(U* p, Args&&... args) {
+    // new(p) - это new expression (конкретнее placement new expression),
     // который вызывает new operator
 
-    new(p) value_type(std::forward<Args>(args)...);
+    new(p) U(std::forward<Args>(args)...);
 }
 
 template<typename T>
-void SimpleAllocator<T>::destroy(void* p) {
-    ::delete(p);
+template<typename U>
+void SimpleAllocator<T>::destroy(U* p) {
+    // деструктор вызываем всегда, даже если память узла не освобождается
+    p->~U();
 }
 
 int main() {
-    return 0;
-}
\ No newline at end of file
+    // request-scoped список: построили, обошли, выбросили
+    SimpleAllocator<int> alloc;
+    std::list<int, SimpleAllocator<int>> lst(alloc);
+    for (int i = 0; i < 10000; i++) {
+        lst.push_back(i);
+    }
+
+    long long sum = 0;
+    for (int value : lst) {
+        sum += value;
+    }
+
+    lst.clear();
+    alloc.Release();
+    return sum == 49995000LL ? 0 : 1;
+}
@@ -1,16 +1,38 @@
+#include <cstddef>
 #include <memory>
 #include <type_traits>
 
+// Monotonic arena: память раздается сдвигом указателя по текущему блоку,
+// при нехватке места цепляется новый блок в 2 раза больше предыдущего.
+// Отдельные узлы не освобождаются, вся память возвращается разом через Release()
+struct MonotonicArena {
+    struct Block {
+        Block* next;
+        std::size_t size;
+    };
+
+    explicit MonotonicArena(std::size_t initial_size);
+    ~MonotonicArena();
+
+    void* allocate(std::size_t bytes, std::size_t alignment);
+    void Release();
+
+    Block* blocks = nullptr;
+    char* cursor = nullptr;
+    char* end = nullptr;
+    std::size_t next_size;
+    // Число аллокаторов, разделяющих арену
+    std::size_t num_allocators = 1;
+};
+
 template<typename T>
 class SimpleAllocator {
-    private:
-        template<typename U> 
+    public:
+        template<typename U>
         struct rebind {
             using other = SimpleAllocator<U>;
         };
 
-    public:
-
         using value_type = T;
         using pointer = T*;
         using reference  = T&;
@@ -18,29 +40,41 @@ class SimpleAllocator {
         using const_reference = const T&;
         using size_type = std::size_t;
         using pointer_difference = std::ptrdiff_t;
-        using propagate_on_container_move_assignment = std::false_type;
+        using propagate_on_container_move_assignment = std::true_type;
         using propagate_on_container_copy_assignment = std::false_type;
-        using propogate_on_container_swap = std::false_type;
+        using propagate_on_container_swap = std::true_type;
         using is_always_equal = std::false_type;
 
         SimpleAllocator();
         SimpleAllocator(const SimpleAllocator& other) noexcept;
+        SimpleAllocator& operator=(const SimpleAllocator& other) noexcept;
         ~SimpleAllocator();
 
         template<typename U>
         SimpleAllocator(const SimpleAllocator<U>& other) noexcept;
-        
+
         SimpleAllocator select_on_container_copy_construction() const;
-        
+
         T* allocate(std::size_t n);
         // void* allocate(std::size_t n, void* cvp);
-        void deallocate(void* p, std::size_t n);
+        void deallocate(T* p, std::size_t n);
         // std::size_t max_size() const noexcept;
-        template<typename... Args>
-        void construct(void* p, Args&&... args);
-        void destroy(void* p);
+        template<typename U, typename... Args>
+        void construct(U* p, Args&&... args);
+        template<typename U>
+        void destroy(U* p);
+
+        // Освобождает все блоки арены разом: узлы, выданные до вызова, становятся невалидными
+        void Release();
+
+        template<typename U, typename V>
+        friend bool operator==(const SimpleAllocator<U>& lhs, const SimpleAllocator<V>& rhs) noexcept;
 
         private:
-            std::size_t num_allocators = 0;
-            void* arena;
-};
\ No newline at end of file
+            template<typename U>
+            friend class SimpleAllocator;
+
+            void detach() noexcept;
+
+            MonotonicArena* arena;
+};